@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <stddef.h>
+#include <vector>
+
+namespace Engine {
+
+struct Arena
+{
+    Arena(const size_t blockLength = 65536);
+    ~Arena();
+
+    void* allocate(const size_t size);
+
+    inline size_t getSize() const
+    {
+        return size;
+    }
+
+    static void* acquire(const size_t size);
+    static void release(void* pointer);
+
+    static thread_local Arena* current;
+
+private:
+    struct alignas(std::max_align_t) Header
+    {
+        Arena* arena;
+    };
+
+    const size_t blockLength;
+
+    std::vector<char*> blocks;
+
+    size_t offset;
+    size_t size = 0;
+
+};
+
+}
@@ -1,21 +1,33 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
-#include <random>
 #include <stddef.h>
 #include <string>
+#include <typeindex>
+#include <vector>
 
 #include "effect.h"
 #include "object.h"
+#include "random.h"
 #include "resource.h"
+#include "waveform.h"
 
 namespace Engine {
 
 struct AudioSource : public ValueObject
 {
     virtual void fillBuffer(double* buffer);
+    virtual void fillBlock(double* buffer, const size_t frames);
+
+    virtual void skip(const size_t frames);
+    virtual void step(const size_t frames);
+
+    virtual bool isSkippable() const;
+
+    virtual double getTail();
 };
 
 struct SingleAudioSource : public AudioSource
@@ -24,9 +36,24 @@ struct SingleAudioSource : public AudioSource
     ~SingleAudioSource();
 
     void fillBuffer(double* buffer) override;
+    void fillBlock(double* buffer, const size_t frames) override;
+
+    void skip(const size_t frames) override;
+    void step(const size_t frames) override;
+
+    double getTail() override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    virtual void renderBlock(const size_t frames);
+
+    void startEffects();
+    void stepEffects(const size_t frames);
+
     double* effectBuffer;
+    double* frameBuffer;
+    double* controls;
 
     ValueObject* volume;
     ValueObject* pan;
@@ -38,11 +65,26 @@ struct Phase : public ValueObject
 {
     double getValue() const override;
 
-    void update() override;
-
     void setDelta(const double delta);
+    void advance(const size_t frames);
+
+    inline void step()
+    {
+        phase += delta;
+
+        // the waveform kernels expect [0, 2pi], negative or very large
+        // frequencies can step past either end in a single frame
+
+        if (phase > utils->twoPi || phase < 0)
+        {
+            phase -= utils->twoPi * floor(phase / utils->twoPi);
+        }
+    }
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
     void reinit() override;
 
@@ -57,16 +99,32 @@ struct Oscillator : public SingleAudioSource
     Oscillator(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* frequency);
     ~Oscillator();
 
-    void update() override;
+    void skip(const size_t frames) override;
+    void step(const size_t frames) override;
+
+    bool isSkippable() const override;
+
+    virtual bool isBankable() const;
+
+    void prepareBlock(double* phases, double* gains, const size_t frames);
+
+    virtual void generate(double* values, const size_t count) const;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
+    void renderBlock(const size_t frames) override;
+
     ValueObject* frequency;
 
     Phase* phase;
 
 private:
+    double* values;
+
     double lastVolume = 0;
 
 };
@@ -76,6 +134,8 @@ struct Sine : public Oscillator
     Sine(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* frequency);
 
     double getValue() const override;
+
+    void generate(double* values, const size_t count) const override;
 };
 
 struct Square : public Oscillator
@@ -83,6 +143,8 @@ struct Square : public Oscillator
     Square(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* frequency);
 
     double getValue() const override;
+
+    void generate(double* values, const size_t count) const override;
 };
 
 struct Saw : public Oscillator
@@ -90,6 +152,8 @@ struct Saw : public Oscillator
     Saw(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* frequency);
 
     double getValue() const override;
+
+    void generate(double* values, const size_t count) const override;
 };
 
 struct Triangle : public Oscillator
@@ -97,6 +161,8 @@ struct Triangle : public Oscillator
     Triangle(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* frequency);
 
     double getValue() const override;
+
+    void generate(double* values, const size_t count) const override;
 };
 
 struct CustomOscillator : public Oscillator
@@ -106,25 +172,51 @@ struct CustomOscillator : public Oscillator
 
     double getValue() const override;
 
+    bool isBankable() const override;
+
+    void serialize(Snapshot& snapshot) override;
+
 protected:
     void init() override;
 
+    void renderBlock(const size_t frames) override;
+
 private:
     ValueObject* waveform;
 
 };
 
+struct OscillatorBank
+{
+    OscillatorBank(const std::vector<Oscillator*>& oscillators, const std::vector<Utils*>& contexts, const std::vector<size_t>& groups);
+    ~OscillatorBank();
+
+    void renderBlock(double* buffers, const size_t stride, const size_t frame, const size_t frames);
+
+private:
+    std::vector<Oscillator*> oscillators;
+    std::vector<Utils*> contexts;
+    std::vector<size_t> groups;
+    std::vector<size_t> order;
+    std::vector<size_t> slots;
+
+    double* phases;
+    double* gains;
+
+};
+
 struct Noise : public SingleAudioSource
 {
     Noise(ValueObject* volume, ValueObject* pan, ValueObject* effects);
 
-    void update() override;
-
 protected:
+    void updateInternal() override;
     void init() override;
 
+    void renderBlock(const size_t frames) override;
+
 private:
-    std::uniform_real_distribution<double> udist = std::uniform_real_distribution<double>(-1, 1);
+    RandomStream random;
 
 };
 
@@ -133,11 +225,16 @@ struct Sample : public SingleAudioSource
     Sample(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* resource);
     ~Sample();
 
-    void update() override;
+    void skip(const size_t frames) override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
+    void renderBlock(const size_t frames) override;
+
 private:
     ValueObject* resource;
 
@@ -151,83 +248,75 @@ struct ShapeCoordinator : public ValueObject
 
     inline void setValue(const double value);
 
+    void serialize(Snapshot& snapshot) override;
+
 private:
     double value = 0;
 
 };
 
-struct Grain : public Sync
+struct GrainPool
 {
-    Grain(ValueObject* resource, ValueObject* shape, ShapeCoordinator* coordinator, const size_t length);
-    ~Grain();
-
-    void apply(double* buffer);
-
-    inline void setLength(const size_t length);
-
-protected:
-    void init() override;
-
-private:
-    size_t clampLength(const size_t max) const;
-    size_t randomIndex(const size_t max) const;
-
-    ValueObject* resource;
-    ValueObject* shape;
+    GrainPool(RandomStream* random);
+    ~GrainPool();
 
-    ShapeCoordinator* coordinator;
+    void reserve(const size_t capacity);
 
-    size_t length;
+    bool spawn(const Resource* resource, const size_t length);
 
-    size_t currentIndex;
-    size_t startIndex;
+    void tabulate(ValueObject* shape, ShapeCoordinator* coordinator, const size_t length);
 
-    bool firstInit = true;
-
-};
+    void apply(double* buffer, const Resource* resource, ValueObject* shape, ShapeCoordinator* coordinator, const size_t grainLength, const size_t maxGrains);
 
-struct GrainNode
-{
-    GrainNode(Grain* grain, GrainNode* prev, GrainNode* next);
-    ~GrainNode();
+    inline size_t getActiveLength() const
+    {
+        return activeLength;
+    }
 
-    Grain* grain;
+    inline size_t getTotalLength() const
+    {
+        return count;
+    }
 
-    GrainNode* prev;
-    GrainNode* next;
+    inline bool isTabulated() const
+    {
+        return envelopeLength > 0;
+    }
 
-    bool active = true;
-};
+    void serialize(Snapshot& snapshot, const Resource* resource);
 
-struct GrainList : public Sync
-{
-    GrainList();
-    ~GrainList();
+private:
+    RandomStream* random;
 
-    void append(Grain* grain);
+    size_t* starts = nullptr;
+    size_t* positions = nullptr;
+    size_t* lengths = nullptr;
 
-    void apply(double* buffer, const size_t grainLength, const size_t maxGrains);
+    bool* active = nullptr;
 
-    inline size_t getActiveLength() const;
-    inline size_t getTotalLength() const;
+    size_t capacity = 0;
+    size_t count = 0;
+    size_t activeLength = 0;
 
-private:
-    GrainNode* head = new GrainNode(nullptr, nullptr, nullptr);
-    GrainNode* tail = new GrainNode(nullptr, nullptr, nullptr);
+    double* envelope = nullptr;
 
-    size_t activeLength = 0;
-    size_t totalLength = 0;
+    size_t envelopeLength = 0;
 
 };
 
 struct Granulate : public SingleAudioSource
 {
-    Granulate(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* resource, ValueObject* grains, ValueObject* length, ValueObject* shape);
+    Granulate(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* resource, ValueObject* grains, ValueObject* length, ValueObject* shape, const bool staticShape = false);
     ~Granulate();
 
-    void update() override;
+    bool isSkippable() const override;
+
+    void serialize(Snapshot& snapshot) override;
+
+    static constexpr size_t shapeResolution = 1024;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -236,9 +325,13 @@ private:
     ValueObject* length;
     ValueObject* shape;
 
+    const bool staticShape;
+
     ShapeCoordinator* coordinator = new ShapeCoordinator();
 
-    GrainList* grainList = new GrainList();
+    GrainPool* grainPool;
+
+    RandomStream random;
 
 };
 
@@ -249,6 +342,8 @@ struct Group : public AudioSource
 
     void fillBuffer(double* buffer) override;
 
+    void serialize(Snapshot& snapshot) override;
+
 protected:
     void init() override;
 
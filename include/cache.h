@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "path.h"
+#include "utils.h"
+
+namespace Engine {
+
+struct MappedFile
+{
+    MappedFile(const Path& path);
+    ~MappedFile();
+
+    inline char* getData() const
+    {
+        return data;
+    }
+
+    inline size_t getSize() const
+    {
+        return size;
+    }
+
+private:
+    char* data = nullptr;
+
+    size_t size = 0;
+
+    void* file = nullptr;
+    void* mapping = nullptr;
+
+};
+
+struct ResourceCache
+{
+    ResourceCache(const Path& directory, const Path& source, const unsigned int sampleRate, const unsigned int channels);
+
+    MappedFile* load(float*& samples, size_t& frames) const;
+
+    void store(const float* samples, const size_t frames) const;
+
+private:
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint64_t digest;
+        uint64_t frames;
+    };
+
+    static constexpr uint32_t magic = 0x4f524743;
+    static constexpr uint32_t version = 4;
+
+    static constexpr size_t digestLength = 65536;
+
+    const unsigned int channels;
+
+    uint64_t key;
+    uint64_t digest;
+
+    std::string path;
+
+};
+
+}
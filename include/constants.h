@@ -21,4 +21,11 @@ struct Constants
         Up,
         Down
     };
+
+    enum Rate
+    {
+        Constant,
+        Control,
+        Audio
+    };
 };
@@ -1,18 +1,21 @@
 #pragma once
 
-#include <random>
 #include <stddef.h>
 #include <unordered_set>
 #include <vector>
 
 #include "constants.h"
 #include "object.h"
+#include "random.h"
 
 namespace Engine {
 
 struct Time : public ValueObject
 {
     double getValue() const override;
+    size_t getBlock(double* values, const size_t frames) override;
+
+    Constants::Rate getRate() const override;
 };
 
 struct Value : public ValueObject
@@ -20,6 +23,10 @@ struct Value : public ValueObject
     Value(const double value);
 
     double getValue() const override;
+    size_t getBlock(double* values, const size_t frames) override;
+
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
 
 private:
     const double value;
@@ -39,10 +46,37 @@ struct ValueNegate : public ValueObject
     ~ValueNegate();
 
     double getValue() const override;
+    size_t getBlock(double* values, const size_t frames) override;
+
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
+    void init() override;
+
+private:
+    ValueObject* value;
+
+};
+
+struct ValueSquare : public ValueObject
+{
+    ValueSquare(ValueObject* value);
+    ~ValueSquare();
+
+    double getValue() const override;
+    size_t getBlock(double* values, const size_t frames) override;
+
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
+
+    void serialize(Snapshot& snapshot) override;
+
+protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -56,15 +90,24 @@ struct ValueCombination : public ValueObject
     ~ValueCombination();
 
     double getValue() const override;
+    size_t getBlock(double* values, const size_t frames) override;
+
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
     virtual double getValueInternal(const double value1, const double value2) const = 0;
+    virtual void getBlockInternal(double* values1, const double* values2, const size_t frames) const;
+    virtual double getMaximumInternal(const double maximum1, const double maximum2) const;
 
 private:
+    static constexpr size_t chunkLength = 256;
+
     ValueObject* value1;
     ValueObject* value2;
 
@@ -76,6 +119,8 @@ struct ValueAdd : public ValueCombination
 
 protected:
     double getValueInternal(const double value1, const double value2) const override;
+    void getBlockInternal(double* values1, const double* values2, const size_t frames) const override;
+    double getMaximumInternal(const double maximum1, const double maximum2) const override;
 
 };
 
@@ -85,6 +130,7 @@ struct ValueSubtract : public ValueCombination
 
 protected:
     double getValueInternal(const double value1, const double value2) const override;
+    void getBlockInternal(double* values1, const double* values2, const size_t frames) const override;
 
 };
 
@@ -94,6 +140,7 @@ struct ValueMultiply : public ValueCombination
 
 protected:
     double getValueInternal(const double value1, const double value2) const override;
+    void getBlockInternal(double* values1, const double* values2, const size_t frames) const override;
 
 };
 
@@ -103,6 +150,7 @@ struct ValueDivide : public ValueCombination
 
 protected:
     double getValueInternal(const double value1, const double value2) const override;
+    void getBlockInternal(double* values1, const double* values2, const size_t frames) const override;
 
 };
 
@@ -167,9 +215,10 @@ struct All : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -184,9 +233,10 @@ struct Any : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -201,9 +251,10 @@ struct None : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -218,9 +269,10 @@ struct Min : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -235,9 +287,10 @@ struct Max : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -252,9 +305,10 @@ struct Round : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -271,14 +325,48 @@ struct Absolute : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
+
+protected:
+    void updateInternal() override;
+    void init() override;
+
+private:
+    ValueObject* value;
+
+};
+
+struct ControlRate : public ValueObject
+{
+    ControlRate(ValueObject* value, const size_t period);
+    ~ControlRate();
+
+    double getValue() const override;
+
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
     ValueObject* value;
 
+    const size_t period;
+
+    size_t step = 0;
+
+    bool resetting = true;
+
+    double event = 0;
+
+    double previous = 0;
+    double target = 0;
+    double current = 0;
+
 };
 
 struct Sequence : public ValueObject
@@ -288,11 +376,15 @@ struct Sequence : public ValueObject
 
     double getValue() const override;
 
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
+
     ValueObject* getLeaf() override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
     void reinit() override;
 
@@ -300,7 +392,7 @@ private:
     ValueObject* controllers;
     ValueObject* order;
 
-    std::uniform_int_distribution<size_t> udist;
+    RandomStream random;
 
     std::unordered_set<size_t> chosen;
 
@@ -318,11 +410,15 @@ struct Repeat : public ValueObject
 
     double getValue() const override;
 
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
+
     ValueObject* getLeaf() override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
     void reinit() override;
 
@@ -341,11 +437,15 @@ struct Hold : public ValueObject
 
     double getValue() const override;
 
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
+
     ValueObject* getLeaf() override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -361,9 +461,13 @@ struct Sweep : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -380,9 +484,13 @@ struct LFO : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -399,9 +507,13 @@ struct Random : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -410,6 +522,8 @@ private:
     ValueObject* length;
     ValueObject* type;
 
+    RandomStream random;
+
     double current;
     double next = 0;
 
@@ -424,9 +538,13 @@ struct Limit : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -445,9 +563,10 @@ struct Trigger : public ValueObject
 
     ValueObject* getLeaf() override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -467,9 +586,10 @@ struct If : public ValueObject
 
     ValueObject* getLeaf() override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -1,17 +1,31 @@
 #pragma once
 
+#include <algorithm>
 #include <cstring>
-#include <queue>
-#include <random>
+#include <limits>
+#include <new>
 #include <stddef.h>
 
+#include "fft.h"
 #include "object.h"
+#include "random.h"
+#include "resource.h"
 
 namespace Engine {
 
+struct Biquad;
+struct DelayBuffer;
+
 struct Effect : public ValueObject
 {
     virtual void apply(double* buffer);
+    virtual void applyBlock(double* buffer, const size_t frames);
+
+    virtual double getTail();
+
+protected:
+    static double getFeedbackTail(const double delay, const double feedback);
+    static double getMaxDelay(const ValueObject* delay);
 };
 
 struct EffectGroup : public Effect
@@ -20,8 +34,14 @@ struct EffectGroup : public Effect
     ~EffectGroup();
 
     void apply(double* buffer) override;
+    void applyBlock(double* buffer, const size_t frames) override;
+
+    double getTail() override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -30,6 +50,7 @@ private:
 
     double* original;
     double* applied;
+    double* controls;
 
 };
 
@@ -39,16 +60,26 @@ struct Delay : public Effect
     ~Delay();
 
     void apply(double* buffer) override;
+    void applyBlock(double* buffer, const size_t frames) override;
+
+    double getTail() override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
+    void applyFrame(double* buffer, const double mixValue, const double delayValue, const double feedbackValue);
+
     ValueObject* mix;
     ValueObject* delay;
     ValueObject* feedback;
 
-    std::queue<double> delayBuffer;
+    DelayBuffer* delayBuffer;
+
+    double* controls;
 
 };
 
@@ -58,16 +89,26 @@ struct Comb : public Effect
     ~Comb();
 
     void apply(double* buffer) override;
+    void applyBlock(double* buffer, const size_t frames) override;
+
+    double getTail() override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
+    void applyFrame(double* buffer, const double mixValue, const double delayValue, const double feedbackValue);
+
     ValueObject* mix;
     ValueObject* delay;
     ValueObject* feedback;
 
-    std::queue<double> delayBuffer;
+    DelayBuffer* delayBuffer;
+
+    double* controls;
 
 };
 
@@ -77,16 +118,26 @@ struct AllPass : public Effect
     ~AllPass();
 
     void apply(double* buffer) override;
+    void applyBlock(double* buffer, const size_t frames) override;
+
+    double getTail() override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
+    void applyFrame(double* buffer, const double mixValue, const double delayValue, const double feedbackValue);
+
     ValueObject* mix;
     ValueObject* delay;
     ValueObject* feedback;
 
-    std::queue<double> delayBuffer;
+    DelayBuffer* delayBuffer;
+
+    double* controls;
 
 };
 
@@ -96,54 +147,93 @@ struct LowPass : public Effect
     ~LowPass();
 
     void apply(double* buffer) override;
+    void applyBlock(double* buffer, const size_t frames) override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
     ValueObject* threshold;
 
-    double* raw;
-    double* filtered;
+    Biquad* filter;
+
+    double* controls;
 
 };
 
-struct RingBuffer
+struct Biquad
 {
-    RingBuffer(const size_t length);
-    ~RingBuffer();
+    Biquad(const size_t lanes);
+    ~Biquad();
+
+    void setLowPass(const double frequency);
+    void setHighPass(const double frequency);
+    void setBandPass(const double frequency, const double q);
 
-    void push(const double value);
+    void apply(double* values);
 
-    double value() const;
+    void serialize(Snapshot& snapshot);
 
 private:
-    const size_t length;
+    enum Response
+    {
+        Low,
+        High,
+        Band
+    };
 
-    double* buffer;
+    inline bool isCached(const Response response, const double frequency, const double q) const
+    {
+        return response == this->response && frequency == cutoff && q == resonance;
+    }
 
-    size_t front = 0;
+    void setCached(const Response response, const double frequency, const double q);
+
+    const size_t lanes;
+
+    double* raw;
+    double* filtered;
+
+    Response response = Low;
+
+    double cutoff = std::numeric_limits<double>::quiet_NaN();
+    double resonance = std::numeric_limits<double>::quiet_NaN();
+
+    double a0 = 0;
+    double a1 = 0;
+    double a2 = 0;
+    double b1 = 0;
+    double b2 = 0;
 
 };
 
-struct DelayLine
+struct DelayBuffer
 {
-    DelayLine(const size_t length);
-    ~DelayLine();
+    DelayBuffer(const double frames);
+    ~DelayBuffer();
+
+    double read(const double delay, const size_t channel) const;
+    void write(const size_t channel, const double value);
+    void advance();
 
-    void push(const double value);
+    void serialize(Snapshot& snapshot);
 
-    double value();
+    static constexpr double maxDelay = 60000;
+    static constexpr double unboundedDelay = 5000;
 
 private:
-    RingBuffer* buffer;
+    double* buffer;
 
-    double raw[2] = { 0 };
-    double filtered[2] = { 0 };
+    const double limit;
 
-    double c0;
-    double c1;
-    double c2;
+    size_t channels;
+    size_t capacity;
+    size_t mask;
+    size_t span;
+    size_t position = 0;
 
 };
 
@@ -152,37 +242,31 @@ struct DelayMatrix
     DelayMatrix();
     ~DelayMatrix();
 
-    void apply(double* buffer, const double feedbackValue, const double mixValue);
+    void apply(double* buffer, const double lengthValue, const double mixValue);
 
-private:
-    const double coeffs[256] =
-    {
-        1, -1, -1, -1, -1, 1, 1, 1, -1, 1, 1, 1, -1, 1, 1, 1,
-        -1, 1, -1, -1, 1, -1, 1, 1, 1, -1, 1, 1, 1, -1, 1, 1,
-        -1, -1, 1, -1, 1, 1, -1, 1, 1, 1, -1, 1, 1, 1, -1, 1,
-        -1, -1, -1, 1, 1, 1, 1, -1, 1, 1, 1, -1, 1, 1, 1, -1,
-        -1, 1, 1, 1, 1, -1, -1, -1, -1, 1, 1, 1, -1, 1, 1, 1,
-        1, -1, 1, 1, -1, 1, -1, -1, 1, -1, 1, 1, 1, -1, 1, 1,
-        1, 1, -1, 1, -1, -1, 1, -1, 1, 1, -1, 1, 1, 1, -1, 1,
-        1, 1, 1, -1, -1, -1, -1, 1, 1, 1, 1, -1, 1, 1, 1, -1,
-        -1, 1, 1, 1, -1, 1, 1, 1, 1, -1, -1, -1, -1, 1, 1, 1,
-        1, -1, 1, 1, 1, -1, 1, 1, -1, 1, -1, -1, 1, -1, 1, 1,
-        1, 1, -1, 1, 1, 1, -1, 1, -1, -1, 1, -1, 1, 1, -1, 1,
-        1, 1, 1, -1, 1, 1, 1, -1, -1, -1, -1, 1, 1, 1, 1, -1,
-        -1, 1, 1, 1, -1, 1, 1, 1, -1, 1, 1, 1, 1, -1, -1, -1,
-        1, -1, 1, 1, 1, -1, 1, 1, 1, -1, 1, 1, -1, 1, -1, -1,
-        1, 1, -1, 1, 1, 1, -1, 1, 1, 1, -1, 1, -1, -1, 1, -1,
-        1, 1, 1, -1, 1, 1, 1, -1, 1, 1, 1, -1, -1, -1, -1, 1
-    };
+    void serialize(Snapshot& snapshot);
+
+    static void transform(double* values);
 
+private:
     Utils* utils;
 
-    DelayLine** lines;
+    double* lines;
+    double* inputs;
+
+    Biquad* damping;
 
-    double* values;
+    size_t offsets[16];
+    size_t lengths[16];
+    size_t positions[16] = { 0 };
+
+    double values[16];
 
     double delayLength;
 
+    double feedbackLength = 0;
+    double feedbackValue = 0;
+
 };
 
 struct Reverb : public Effect
@@ -191,8 +275,14 @@ struct Reverb : public Effect
     ~Reverb();
 
     void apply(double* buffer) override;
+    void applyBlock(double* buffer, const size_t frames) override;
+
+    double getTail() override;
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -201,6 +291,52 @@ private:
 
     DelayMatrix* matrix = new DelayMatrix();
 
+    double* controls;
+
+};
+
+struct Convolve : public Effect
+{
+    Convolve(ValueObject* mix, Resource* impulse);
+    ~Convolve();
+
+    void apply(double* buffer) override;
+    void applyBlock(double* buffer, const size_t frames) override;
+
+    double getTail() override;
+
+    void serialize(Snapshot& snapshot) override;
+
+protected:
+    void updateInternal() override;
+    void init() override;
+
+private:
+    void applyFrame(double* buffer, const double mixValue);
+    void process();
+
+    static constexpr size_t partitionLength = 512;
+
+    ValueObject* mix;
+
+    Resource* impulse;
+
+    FFT* fft;
+
+    size_t partitions;
+
+    std::complex<double>* filters;
+    std::complex<double>* spectra;
+    std::complex<double>* block;
+
+    double* head;
+    double* input;
+    double* output;
+    double* controls;
+
+    size_t position = 0;
+    size_t current = 0;
+
 };
 
 }
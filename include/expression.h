@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdlib>
+#include <stddef.h>
+#include <vector>
+
+#include "controller.h"
+#include "object.h"
+
+namespace Engine {
+
+enum struct Opcode
+{
+    Load,
+    Negate,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Power,
+    Equals,
+    Less,
+    Greater,
+    LessEqual,
+    GreaterEqual
+};
+
+struct Instruction
+{
+    Opcode opcode;
+
+    size_t output;
+    size_t input1;
+    size_t input2;
+};
+
+struct Expression : public ValueObject
+{
+    Expression(const std::vector<Instruction>& instructions, const std::vector<ValueObject*>& inputs, const std::vector<double>& constants, const size_t output);
+    ~Expression();
+
+    double getValue() const override;
+
+    static double evaluate(const Opcode& opcode, const double value1, const double value2);
+
+    static bool isLeftIdentity(const Opcode& opcode, const double value);
+    static bool isRightIdentity(const Opcode& opcode, const double value);
+
+    void serialize(Snapshot& snapshot) override;
+
+protected:
+    void updateInternal() override;
+    void init() override;
+
+private:
+    const std::vector<Instruction> instructions;
+    const std::vector<ValueObject*> inputs;
+
+    const size_t output;
+
+    double* registers;
+
+};
+
+struct ExpressionBuilder
+{
+    size_t constant(const double value);
+    size_t load(ValueObject* input);
+    size_t unary(const Opcode& opcode, const size_t input);
+    size_t binary(const Opcode& opcode, const size_t input1, const size_t input2);
+
+    ValueObject* build(const size_t output) const;
+
+private:
+    size_t allocate(const double value, const bool known);
+
+    std::vector<Instruction> instructions;
+    std::vector<ValueObject*> inputs;
+    std::vector<double> constants;
+    std::vector<bool> known;
+
+};
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <stddef.h>
+#include <vector>
+
+namespace Engine {
+
+struct FFT
+{
+    FFT(const size_t size);
+
+    void forward(std::complex<double>* values) const;
+    void inverse(std::complex<double>* values) const;
+
+    inline size_t getSize() const
+    {
+        return size;
+    }
+
+private:
+    void transform(std::complex<double>* values) const;
+
+    const size_t size;
+
+    std::vector<size_t> reversed;
+    std::vector<std::complex<double>> twiddles;
+
+};
+
+}
@@ -15,10 +15,17 @@ struct ProgramOptions
     std::optional<double> time;
     std::optional<double> fastForward;
     std::optional<Path> exportPath;
+    std::optional<Path> loadState;
+    std::optional<Path> saveState;
     std::optional<unsigned int> channels;
     std::optional<unsigned int> sampleRate;
     std::optional<unsigned int> bufferLength;
+    std::optional<unsigned int> lookahead;
+    std::optional<unsigned int> threads;
     std::optional<size_t> seed;
+    std::optional<bool> bytecode;
+    std::optional<unsigned int> controlPeriod;
+    std::optional<Path> cache;
 };
 
 struct FlagParser
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <limits>
 #include <stddef.h>
 #include <typeindex>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "arena.h"
+#include "constants.h"
+#include "snapshot.h"
 #include "utils.h"
 
 namespace Engine {
@@ -13,18 +19,30 @@ namespace Engine {
 struct Sync
 {
     Sync();
+    ~Sync();
 
     void start(const double time);
     void repeat(const double time);
     void stop(const double time);
 
+    inline double getStartTime() const
+    {
+        return startTime;
+    }
+
     inline double getStopTime() const
     {
         return stopTime;
     }
 
+    void bind(Utils* utils);
+
+    virtual void serialize(Snapshot& snapshot);
+
     bool enabled = false;
 
+    static thread_local std::unordered_set<Sync*>* created;
+
 protected:
     virtual void init();
     virtual void reinit();
@@ -37,6 +55,28 @@ protected:
 
 };
 
+struct ArenaScope
+{
+    inline ArenaScope(Arena* arena, std::unordered_set<Sync*>* created = nullptr) :
+        arena(Arena::current), created(Sync::created)
+    {
+        Arena::current = arena;
+        Sync::created = created;
+    }
+
+    inline ~ArenaScope()
+    {
+        Arena::current = arena;
+        Sync::created = created;
+    }
+
+private:
+    Arena* const arena;
+
+    std::unordered_set<Sync*>* const created;
+
+};
+
 struct ValueObject;
 
 struct Defaults
@@ -49,14 +89,20 @@ struct Defaults
 
         if (!objects.count(index))
         {
+            ArenaScope scope(nullptr);
+
             objects[index] = new T();
         }
 
-        return static_cast<T*>(objects[index]);
+        T* object = static_cast<T*>(objects[index]);
+
+        object->bind(Utils::get());
+
+        return object;
     }
 
 private:
-    static inline std::unordered_map<std::type_index, ValueObject*> objects;
+    static inline thread_local std::unordered_map<std::type_index, ValueObject*> objects;
 
 };
 
@@ -64,7 +110,16 @@ struct ValueObject : public Sync
 {
     virtual ~ValueObject();
 
+    static void* operator new(const size_t size);
+    static void operator delete(void* pointer);
+
     virtual double getValue() const;
+    virtual size_t getBlock(double* values, const size_t frames);
+
+    void updateBlock(const size_t frames);
+
+    virtual Constants::Rate getRate() const;
+    virtual double getMaximum() const;
 
     virtual ValueObject* getLeaf();
 
@@ -78,7 +133,40 @@ struct ValueObject : public Sync
         return Defaults::get<T>();
     }
 
-    virtual void update();
+    inline void update()
+    {
+        if (utils->frame > updateFrame || updateGeneration != utils->generation)
+        {
+            updateFrame = utils->frame;
+            updateGeneration = utils->generation;
+
+            updateInternal();
+        }
+    }
+
+    void serialize(Snapshot& snapshot) override;
+
+protected:
+    virtual void updateInternal();
+
+    inline void markUpdated(const size_t frames)
+    {
+        if (frames > 0)
+        {
+            updateFrame = utils->frame + frames - 1;
+            updateGeneration = utils->generation;
+        }
+    }
+
+    size_t finishBlock(ValueObject* value, double* values, const size_t active, const size_t frames);
+
+private:
+    size_t updateFrame = -1;
+    size_t updateGeneration = -1;
+
+    size_t blockStop = -1;
+    size_t blockGeneration = -1;
+
 };
 
 struct List : public ValueObject
@@ -86,6 +174,8 @@ struct List : public ValueObject
     List(const std::vector<ValueObject*>& objects = {});
     ~List();
 
+    void serialize(Snapshot& snapshot) override;
+
     const std::vector<ValueObject*> objects;
 };
 
@@ -94,16 +184,59 @@ struct Variable : public ValueObject
     Variable(ValueObject* value);
 
     double getValue() const override;
+    size_t getBlock(double* values, const size_t frames) override;
+
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
 
     ValueObject* getLeaf() override;
 
-    void update() override;
+    void serialize(Snapshot& snapshot) override;
 
     ValueObject* value;
 
 protected:
+    void updateInternal() override;
+    void init() override;
+
+};
+
+struct SharedValue : public ValueObject
+{
+    SharedValue(ValueObject* value);
+    ~SharedValue();
+
+    double getValue() const override;
+    size_t getBlock(double* values, const size_t frames) override;
+
+    Constants::Rate getRate() const override;
+    double getMaximum() const override;
+
+    ValueObject* getLeaf() override;
+
+    void serialize(Snapshot& snapshot) override;
+
+protected:
+    void updateInternal() override;
     void init() override;
 
+private:
+    void evaluate(const size_t frames);
+
+    inline bool holds(const size_t frame) const
+    {
+        return historyGeneration == utils->generation && frame >= historyStart && frame < historyStart + historyLength;
+    }
+
+    ValueObject* value;
+
+    double* history;
+
+    size_t historyStart = 0;
+    size_t historyLength = 0;
+    size_t historyStop = -1;
+    size_t historyGeneration = -1;
+
 };
 
 struct Lambda : public ValueObject
@@ -114,11 +247,12 @@ struct Lambda : public ValueObject
 
     double getValue() const override;
 
-    void update() override;
-
     void setInputs(const std::vector<ValueObject*>& values);
 
+    void serialize(Snapshot& snapshot) override;
+
 protected:
+    void updateInternal() override;
     void init() override;
 
 private:
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdlib>
+#include <fstream>
 #include <functional>
 #include <limits.h>
 #include <string>
@@ -19,6 +21,7 @@
 #include "parse.h"
 #include "path.h"
 #include "program.h"
+#include "queue.h"
 #include "token.h"
 #include "transform.h"
 #include "utils.h"
@@ -34,6 +37,14 @@ private:
     void startPlayback();
     void startExport();
 
+    void loadState();
+    void saveState() const;
+
+    void render();
+    void renderAhead(double* block);
+
+    void writeExport(SndfileHandle* file, const size_t length);
+
     int processAudio(void* output, const unsigned int frames);
 
     void audioError(const std::string& message) const;
@@ -44,4 +55,10 @@ private:
 
     Engine::Program* program;
 
+    SampleQueue* queue = nullptr;
+
+    std::atomic<bool> rendering = false;
+    std::atomic<bool> exportFailed = false;
+    std::atomic<size_t> underruns = 0;
+
 };
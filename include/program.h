@@ -1,26 +1,71 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <vector>
 
+#include "arena.h"
 #include "audiosource.h"
 #include "object.h"
+#include "worker.h"
 
 namespace Engine {
 
 struct Program : public ValueObject
 {
-    Program(const std::vector<ValueObject*>& variables, const std::vector<ValueObject*>& audioSources);
+    Program(const std::vector<ValueObject*>& variables, const std::vector<ValueObject*>& audioSources, const std::vector<std::vector<ValueObject*>>& sourceGroups, const std::vector<Utils*>& contexts, Arena* arena = nullptr);
     ~Program();
 
-    void processAudioSources(double* buffer) const;
+    void processBlock(double* buffer, const size_t frames);
+    void seek(const size_t frames);
+
+    size_t getMemoryUsage() const;
+
+    std::vector<char> save();
+    void restore(const std::vector<char>& data);
+
+    void serialize(Snapshot& snapshot) override;
 
 protected:
     void init() override;
 
 private:
+    void createBanks();
+    void planTasks();
+
+    void renderGroup(const size_t index, const size_t frames);
+    void mixGroups(double* buffer, const size_t start, const size_t end);
+    void renderSource(ValueObject* source, Utils* context, double* buffer, const size_t frames);
+
+    void skipGroup(const size_t index, const size_t frames);
+
+    size_t getTail();
+
     const std::vector<ValueObject*> variables;
     const std::vector<ValueObject*> audioSources;
 
+    const std::vector<std::vector<ValueObject*>> sourceGroups;
+    const std::vector<Utils*> contexts;
+
+    const size_t blockLength;
+
+    double* groupBuffer;
+
+    std::vector<OscillatorBank*> banks;
+    std::vector<bool> banked;
+
+    std::vector<double> groupCosts;
+    std::vector<double> taskCosts;
+
+    std::vector<std::vector<size_t>> batches;
+    std::vector<std::vector<size_t>> dependencies;
+
+    static constexpr size_t tasksPerWorker = 4;
+
+    WorkerPool* workers = nullptr;
+
+    Arena* arena;
+
 };
 
 }
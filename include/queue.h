@@ -0,0 +1,28 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stddef.h>
+
+struct SampleQueue
+{
+    SampleQueue(const size_t capacity);
+    ~SampleQueue();
+
+    size_t write(const double* samples, const size_t count);
+    size_t read(double* samples, const size_t count);
+
+    size_t available() const;
+    size_t space() const;
+
+private:
+    const size_t capacity;
+
+    double* buffer;
+
+    std::atomic<size_t> head = 0;
+    std::atomic<size_t> tail = 0;
+
+};
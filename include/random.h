@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <stddef.h>
+
+namespace Engine {
+
+struct RandomStream
+{
+    typedef uint64_t result_type;
+
+    RandomStream();
+    RandomStream(const uint64_t seed, const uint64_t stream);
+
+    result_type operator()();
+
+    double uniform();
+    double uniform(const double min, const double max);
+
+    size_t index(const size_t max);
+
+    inline void seek(const uint64_t counter)
+    {
+        this->counter = counter;
+    }
+
+    inline void discard(const uint64_t count)
+    {
+        counter += count;
+    }
+
+    inline uint64_t tell() const
+    {
+        return counter;
+    }
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+private:
+    void generate(const uint64_t block);
+
+    uint32_t key[2];
+    uint64_t stream;
+    uint64_t counter = 0;
+
+    uint64_t cachedBlock = -1;
+    uint64_t cached[2];
+
+};
+
+}
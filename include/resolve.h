@@ -49,6 +49,7 @@ struct TypeResolver
     static void resolveTypes(const AllPass* token);
     static void resolveTypes(const LowPass* token);
     static void resolveTypes(const Reverb* token);
+    static void resolveTypes(const Convolve* token);
     static void resolveTypes(const CallUser* token);
     static void resolveTypes(const CallAlias* token);
     static void resolveTypes(const Program* token);
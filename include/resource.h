@@ -1,23 +1,52 @@
 #pragma once
 
+#include <memory>
+#include <optional>
 #include <samplerate.h>
 #include <sndfile.hh>
 
+#include "cache.h"
 #include "exception.h"
 #include "object.h"
 #include "path.h"
 
 namespace Engine {
 
+struct ResourceData
+{
+    ResourceData(const Path& path, const SourceLocation& location, const std::optional<Path>& cacheDirectory = std::nullopt);
+    ~ResourceData();
+
+    float* samples = nullptr;
+
+    size_t frames = 0;
+
+private:
+    static float* mix(const float* interleaved, const size_t frames, const unsigned int inputChannels, const unsigned int outputChannels);
+
+    MappedFile* mapping = nullptr;
+
+};
+
+typedef std::shared_ptr<const ResourceData> SharedResourceData;
+
 struct Resource : public ValueObject
 {
-    Resource(const Path& path, const SourceLocation& location);
+    Resource(const SharedResourceData& data);
     Resource();
-    ~Resource();
 
-    double* samples;
+    inline const float* getChannel(const size_t channel) const
+    {
+        return samples + channel * frames;
+    }
+
+    const float* samples;
+
+    size_t frames;
+
+private:
+    const SharedResourceData data;
 
-    size_t length;
 };
 
 }
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stddef.h>
+#include <unordered_set>
+#include <vector>
+
+#include "exception.h"
+#include "random.h"
+
+namespace Engine {
+
+struct Sync;
+
+struct Snapshot
+{
+    Snapshot();
+    Snapshot(const std::vector<char>& data);
+
+    template <typename T> inline void value(T& value)
+    {
+        bytes(&value, sizeof(T));
+    }
+
+    void bytes(void* data, const size_t size);
+    void random(RandomStream& stream);
+    void object(Sync* object);
+
+    void require(const size_t count, const size_t size) const;
+    void expect(const bool valid) const;
+
+    void finish() const;
+
+    inline bool isRestoring() const
+    {
+        return restoring;
+    }
+
+    inline const std::vector<char>& getData() const
+    {
+        return data;
+    }
+
+private:
+    static constexpr uint32_t magic = 0x4f524753;
+    static constexpr uint32_t swappedMagic = 0x5347524f;
+    static constexpr uint32_t version = 1;
+
+    std::vector<char> data;
+
+    const bool restoring;
+
+    size_t offset = 0;
+
+    std::unordered_set<Sync*> visited;
+
+};
+
+}
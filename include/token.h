@@ -719,6 +719,15 @@ struct Reverb : public Effect
     Engine::ValueObject* transform(TokenTransformer* visitor) const override;
 };
 
+struct Convolve : public Effect
+{
+    Convolve(const SourceLocation& location, ArgumentList* arguments);
+
+    void resolveTypes() const override;
+
+    Engine::ValueObject* transform(TokenTransformer* visitor) const override;
+};
+
 struct CallUser : public Call
 {
     CallUser(const SourceLocation& location, ArgumentList* arguments, const FunctionDef* function);
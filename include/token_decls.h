@@ -16,6 +16,7 @@ struct InputRef;
 struct FunctionDef;
 struct FunctionRef;
 struct EmptyLambda;
+struct Argument;
 struct ArgumentList;
 struct List;
 struct ParenthesizedExpression;
@@ -54,6 +55,7 @@ struct Comb;
 struct AllPass;
 struct LowPass;
 struct Reverb;
+struct Convolve;
 struct CallUser;
 struct CallAlias;
 struct AddAlias;
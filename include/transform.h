@@ -1,11 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <stddef.h>
 #include <string>
+#include <typeindex>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "controller.h"
+#include "expression.h"
 #include "object.h"
 #include "path.h"
 #include "program.h"
@@ -17,7 +24,7 @@
 
 struct TokenTransformer
 {
-    TokenTransformer(const Path& sourcePath);
+    TokenTransformer(const Path& sourcePath, const bool bytecode = false, const unsigned int controlPeriod = 1, const std::optional<Path>& cacheDirectory = std::nullopt);
 
     Engine::ValueObject* transform(const Parser::Value* token);
     Engine::ValueObject* transform(const Parser::Constant* token);
@@ -64,6 +71,7 @@ struct TokenTransformer
     Engine::ValueObject* transform(const Parser::AllPass* token);
     Engine::ValueObject* transform(const Parser::LowPass* token);
     Engine::ValueObject* transform(const Parser::Reverb* token);
+    Engine::ValueObject* transform(const Parser::Convolve* token);
     Engine::ValueObject* transform(const Parser::CallUser* token);
     Engine::ValueObject* transform(const Parser::AddAlias* token);
     Engine::ValueObject* transform(const Parser::SubtractAlias* token);
@@ -81,12 +89,50 @@ struct TokenTransformer
 private:
     Engine::ValueObject* transformArgument(const Parser::ArgumentList* arguments, const std::string& name);
 
+    Engine::ValueObject* controlRate(Engine::ValueObject* value) const;
+
+    Engine::Resource* loadResource(const Parser::Argument* argument);
+
+    bool isStaticShape(const Parser::Token* token) const;
+    bool isPure(const Parser::Token* token, const std::vector<const Parser::InputDef*>& inputs) const;
+
+    Engine::ValueObject* compileExpression(const Parser::Token* token);
+
+    size_t compileOperand(const Parser::Token* token, Engine::ExpressionBuilder& builder);
+
+    Engine::ValueObject* combine(const Engine::Opcode& opcode, Engine::ValueObject* a, Engine::ValueObject* b) const;
+
     void setVariable(const Parser::Identifier* name, Engine::ValueObject* value);
 
+    Engine::ValueObject* share(const Parser::Token* token, Engine::ValueObject* value) const;
+    Engine::ValueObject* referenceVariable(const Parser::Identifier* name);
+
+    void collectReferences(Engine::ValueObject* value, std::unordered_set<Engine::ValueObject*>& references) const;
+
+    std::vector<std::vector<Engine::ValueObject*>> groupSources(const std::vector<Engine::ValueObject*>& sources, const std::vector<std::unordered_set<Engine::ValueObject*>>& references) const;
+
+    std::vector<Utils*> createContexts(const std::vector<std::vector<Engine::ValueObject*>>& groups, const std::vector<Engine::ValueObject*>& sources, const std::vector<std::unordered_set<Engine::ValueObject*>>& references, const std::vector<std::unordered_set<Engine::Sync*>>& created, const std::vector<Engine::ValueObject*>& owners) const;
+
     const Path sourcePath;
 
+    const bool bytecode;
+
+    const unsigned int controlPeriod;
+
+    const std::optional<Path> cacheDirectory;
+
     std::unordered_map<const Parser::Identifier*, Engine::ValueObject*> currentVariables;
 
+    std::unordered_map<Engine::ValueObject*, std::unordered_set<Engine::ValueObject*>> variableReferences;
+
+    std::unordered_set<Engine::ValueObject*> currentReferences;
+
+    std::unordered_map<Engine::ValueObject*, double> constants;
+
     std::vector<Engine::ValueObject*> allVariables;
 
+    std::unordered_map<Path, Engine::SharedResourceData, Path::Hash, Path::Equals> resources;
+
+    size_t lambdaDepth = 0;
+
 };
@@ -14,7 +14,7 @@
 #include <limits>
 #include <mutex>
 #include <optional>
-#include <random>
+#include <stdexcept>
 #include <stddef.h>
 #include <string>
 
@@ -31,6 +31,7 @@ enum struct WarnLevel
 struct Utils
 {
     static Utils* get();
+    static Utils* set(Utils* utils);
 
     static void printInfo();
     static void setWarnLevel(const WarnLevel& level);
@@ -41,11 +42,20 @@ struct Utils
 
     void setSeed(const std::optional<size_t>& seed);
 
+    inline void setFrame(const size_t frame)
+    {
+        this->frame = frame;
+
+        time = frame * timeStep;
+    }
+
     unsigned int channels;
     unsigned int sampleRate;
     unsigned int bufferLength;
+    unsigned int threads = 1;
 
     size_t seed;
+    size_t streams = 0;
 
     const double pi = M_PI;
     const double twoPi = M_PI * 2;
@@ -55,10 +65,14 @@ struct Utils
     double time = 0;
     double timeStep;
 
-    std::mt19937_64 rng;
+    size_t frame = 0;
+    size_t generation = 0;
+    size_t transitions = 0;
+
+    bool seeking = false;
 
 private:
-    static Utils* instance;
+    static thread_local Utils* current;
 
     WarnLevel warnLevel = WarnLevel::Display;
 
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <stddef.h>
+
+#include "utils.h"
+
+namespace Engine {
+
+struct Waveform
+{
+    static inline double sine(const double phase)
+    {
+        const double y = phase - M_PI;
+        const double x = std::max(-M_PI - y, std::min(M_PI - y, y));
+        const double x2 = x * x;
+
+        return -x * (1 + x2 * (-1.0 / 6 + x2 * (1.0 / 120 + x2 * (-1.0 / 5040 + x2 * (1.0 / 362880 + x2 * (-1.0 / 39916800 + x2 * (1.0 / 6227020800 + x2 * (-1.0 / 1307674368000))))))));
+    }
+
+    static inline double square(const double phase)
+    {
+        return phase > 0 && phase <= M_PI ? -1 : 1;
+    }
+
+    static inline double saw(const double phase)
+    {
+        return phase / M_PI - 1;
+    }
+
+    static inline double triangle(const double phase)
+    {
+        const double x = phase * M_2_PI;
+
+        return std::max(std::min(x, 2 - x), x - 4);
+    }
+
+    static void sine(double* values, const size_t count);
+    static void square(double* values, const size_t count);
+    static void saw(double* values, const size_t count);
+    static void triangle(double* values, const size_t count);
+};
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stddef.h>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+
+struct WorkerPool
+{
+    WorkerPool(const size_t threads);
+    ~WorkerPool();
+
+    void run(const std::vector<double>& costs, const std::vector<std::vector<size_t>>& dependencies, const std::function<void(const size_t)>& task);
+
+    inline size_t getThreads() const
+    {
+        return queues.size();
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+
+        std::deque<size_t> tasks;
+    };
+
+    void work(const size_t index);
+    void perform(const size_t index);
+    void release(const size_t index, const size_t task);
+
+    bool take(const size_t index, size_t& next);
+    bool steal(const size_t index, size_t& next);
+
+    std::vector<std::thread> workers;
+
+    std::vector<Queue> queues;
+
+    std::mutex lock;
+
+    std::condition_variable started;
+    std::condition_variable finished;
+
+    const std::function<void(const size_t)>* task = nullptr;
+
+    std::vector<std::vector<size_t>> successors;
+    std::vector<std::atomic<size_t>> remaining;
+
+    std::atomic<size_t> unfinished = 0;
+
+    size_t pending = 0;
+    size_t generation = 0;
+
+    bool stopping = false;
+
+};
+
+}
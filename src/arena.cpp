@@ -0,0 +1,73 @@
+#include "../include/arena.h"
+
+using namespace Engine;
+
+thread_local Arena* Arena::current = nullptr;
+
+Arena::Arena(const size_t blockLength) :
+    blockLength(blockLength), offset(blockLength) {}
+
+Arena::~Arena()
+{
+    for (char* block : blocks)
+    {
+        free(block);
+    }
+}
+
+void* Arena::allocate(const size_t size)
+{
+    const size_t aligned = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+    if (aligned > blockLength)
+    {
+        char* block = (char*)calloc(aligned, 1);
+
+        blocks.insert(blocks.end() - (blocks.empty() ? 0 : 1), block);
+
+        this->size += aligned;
+
+        return block;
+    }
+
+    if (offset + aligned > blockLength)
+    {
+        blocks.push_back((char*)calloc(blockLength, 1));
+
+        offset = 0;
+    }
+
+    void* pointer = blocks.back() + offset;
+
+    offset += aligned;
+
+    this->size += aligned;
+
+    return pointer;
+}
+
+void* Arena::acquire(const size_t size)
+{
+    const size_t total = sizeof(Header) + size;
+
+    Header* header = (Header*)(current ? current->allocate(total) : calloc(total, 1));
+
+    header->arena = current;
+
+    return header + 1;
+}
+
+void Arena::release(void* pointer)
+{
+    if (!pointer)
+    {
+        return;
+    }
+
+    Header* header = (Header*)pointer - 1;
+
+    if (!header->arena)
+    {
+        free(header);
+    }
+}
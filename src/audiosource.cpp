@@ -4,15 +4,58 @@ using namespace Engine;
 
 void AudioSource::fillBuffer(double* buffer) {}
 
+void AudioSource::skip(const size_t)
+{
+    update();
+}
+
+void AudioSource::step(const size_t frames)
+{
+    updateBlock(frames);
+}
+
+bool AudioSource::isSkippable() const
+{
+    return true;
+}
+
+double AudioSource::getTail()
+{
+    return 0;
+}
+
+void AudioSource::fillBlock(double* buffer, const size_t frames)
+{
+    const size_t start = utils->frame;
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        utils->setFrame(start + i);
+
+        update();
+
+        if (enabled)
+        {
+            fillBuffer(buffer + i * utils->channels);
+        }
+    }
+
+    utils->setFrame(start);
+}
+
 SingleAudioSource::SingleAudioSource(ValueObject* volume, ValueObject* pan, ValueObject* effects) :
     volume(volume), pan(pan), effects(effects)
 {
-    effectBuffer = (double*)malloc(sizeof(double) * utils->channels);
+    effectBuffer = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U) * utils->channels);
+    frameBuffer = effectBuffer;
+
+    controls = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U) * 3);
 }
 
 SingleAudioSource::~SingleAudioSource()
 {
-    free(effectBuffer);
+    Arena::release(effectBuffer);
+    Arena::release(controls);
 
     delete volume;
     delete pan;
@@ -23,6 +66,7 @@ void SingleAudioSource::fillBuffer(double* buffer)
 {
     for (ValueObject* object : effects->getLeafAs<List>()->objects)
     {
+        object->update();
         object->getLeafAs<Effect>()->apply(effectBuffer);
     }
 
@@ -32,19 +76,108 @@ void SingleAudioSource::fillBuffer(double* buffer)
     }
 }
 
-double Phase::getValue() const
+void SingleAudioSource::fillBlock(double* buffer, const size_t frames)
 {
-    return phase;
+    renderBlock(frames);
+
+    for (ValueObject* object : effects->getLeafAs<List>()->objects)
+    {
+        object->getLeafAs<Effect>()->applyBlock(effectBuffer, frames);
+    }
+
+    for (size_t i = 0; i < frames * utils->channels; i++)
+    {
+        buffer[i] += effectBuffer[i];
+    }
 }
 
-void Phase::update()
+void SingleAudioSource::skip(const size_t)
 {
-    phase += delta;
+    volume->update();
+    pan->update();
+    effects->update();
+}
 
-    if (phase > utils->twoPi)
+void SingleAudioSource::step(const size_t frames)
+{
+    renderBlock(frames);
+
+    stepEffects(frames);
+}
+
+double SingleAudioSource::getTail()
+{
+    double tail = 0;
+
+    for (ValueObject* object : effects->getLeafAs<List>()->objects)
     {
-        phase -= utils->twoPi;
+        tail = std::max(tail, object->getLeafAs<Effect>()->getTail());
     }
+
+    return tail;
+}
+
+void SingleAudioSource::renderBlock(const size_t frames)
+{
+    const size_t start = utils->frame;
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        utils->setFrame(start + i);
+
+        frameBuffer = effectBuffer + i * utils->channels;
+
+        update();
+
+        if (!enabled)
+        {
+            memset(frameBuffer, 0, sizeof(double) * utils->channels);
+        }
+    }
+
+    frameBuffer = effectBuffer;
+
+    utils->setFrame(start);
+}
+
+void SingleAudioSource::startEffects()
+{
+    effects->start(startTime);
+
+    for (ValueObject* object : effects->getLeafAs<List>()->objects)
+    {
+        object->start(startTime);
+    }
+}
+
+void SingleAudioSource::stepEffects(const size_t frames)
+{
+    // only the controllers of the effects are advanced, their tails are
+    // rendered before the target instead
+
+    for (ValueObject* object : effects->getLeafAs<List>()->objects)
+    {
+        object->updateBlock(frames);
+    }
+}
+
+void SingleAudioSource::serialize(Snapshot& snapshot)
+{
+    AudioSource::serialize(snapshot);
+
+    snapshot.object(volume);
+    snapshot.object(pan);
+    snapshot.object(effects);
+}
+
+double Phase::getValue() const
+{
+    return phase;
+}
+
+void Phase::updateInternal()
+{
+    step();
 }
 
 void Phase::setDelta(const double delta)
@@ -52,6 +185,16 @@ void Phase::setDelta(const double delta)
     this->delta = delta;
 }
 
+void Phase::advance(const size_t frames)
+{
+    phase = fmod(phase + delta * frames, utils->twoPi);
+
+    if (phase < 0)
+    {
+        phase += utils->twoPi;
+    }
+}
+
 void Phase::init()
 {
     phase = 0;
@@ -62,16 +205,31 @@ void Phase::reinit()
     phase = 0;
 }
 
+void Phase::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.value(phase);
+    snapshot.value(delta);
+}
+
 Oscillator::Oscillator(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* frequency) :
-    SingleAudioSource(volume, pan, effects), frequency(frequency), phase(new Phase()) {}
+    SingleAudioSource(volume, pan, effects), frequency(frequency), phase(new Phase())
+{
+    values = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U));
+
+    memset(values, 0, sizeof(double) * std::max(utils->bufferLength, 1U));
+}
 
 Oscillator::~Oscillator()
 {
+    Arena::release(values);
+
     delete frequency;
     delete phase;
 }
 
-void Oscillator::update()
+void Oscillator::updateInternal()
 {
     volume->update();
     pan->update();
@@ -82,7 +240,7 @@ void Oscillator::update()
 
     if (frequencyValue == 0)
     {
-        memset(effectBuffer, 0, sizeof(double) * utils->channels);
+        memset(frameBuffer, 0, sizeof(double) * utils->channels);
 
         return;
     }
@@ -100,17 +258,23 @@ void Oscillator::update()
     lastVolume = volumeValue;
 
     const double panValue = pan->getValue();
-    const double value = volumeValue * getValue();
 
     if (utils->channels == 1)
     {
-        effectBuffer[0] = value;
+        frameBuffer[0] = volumeValue;
     }
 
     else
     {
-        effectBuffer[0] = value * (1 - panValue) / 2;
-        effectBuffer[1] = value * (panValue + 1) / 2;
+        frameBuffer[0] = volumeValue * (1 - panValue) / 2;
+        frameBuffer[1] = volumeValue * (panValue + 1) / 2;
+    }
+
+    const double value = getValue();
+
+    for (size_t i = 0; i < utils->channels; i++)
+    {
+        frameBuffer[i] *= value;
     }
 }
 
@@ -118,17 +282,169 @@ void Oscillator::init()
 {
     volume->start(startTime);
     pan->start(startTime);
-    effects->start(startTime);
+    startEffects();
     frequency->start(startTime);
     phase->start(startTime);
 }
 
+void Oscillator::skip(const size_t frames)
+{
+    SingleAudioSource::skip(frames);
+
+    frequency->update();
+
+    const double frequencyValue = frequency->getValue();
+    const double volumeValue = volume->getValue();
+
+    if (frequencyValue != 0 && frames > 0)
+    {
+        // the first skipped frame is stepped exactly as a render would,
+        // including the reset when the oscillator starts sounding, so only
+        // the frames after it are advanced in closed form
+
+        phase->setDelta(utils->twoPi * frequencyValue / utils->sampleRate);
+        phase->step();
+
+        if (lastVolume == 0 && volumeValue != 0)
+        {
+            phase->repeat(utils->time);
+        }
+
+        phase->advance(frames - 1);
+    }
+
+    lastVolume = volumeValue;
+}
+
+void Oscillator::step(const size_t frames)
+{
+    // the phase is stepped exactly as a render would, without generating
+    // the waveform
+
+    prepareBlock(values, effectBuffer, frames);
+
+    stepEffects(frames);
+}
+
+bool Oscillator::isSkippable() const
+{
+    return frequency->getRate() == Constants::Constant && volume->getRate() == Constants::Constant;
+}
+
+bool Oscillator::isBankable() const
+{
+    for (const ValueObject* object : effects->getLeafAs<List>()->objects)
+    {
+        if (typeid(*object) != typeid(Effect))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Oscillator::renderBlock(const size_t frames)
+{
+    prepareBlock(values, effectBuffer, frames);
+
+    generate(values, frames);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        for (size_t j = 0; j < utils->channels; j++)
+        {
+            effectBuffer[i * utils->channels + j] *= values[i];
+        }
+    }
+}
+
+void Oscillator::prepareBlock(double* phases, double* gains, const size_t frames)
+{
+    const size_t start = utils->frame;
+    const size_t length = std::max(utils->bufferLength, 1U);
+
+    double* volumes = controls;
+    double* pans = controls + length;
+    double* frequencies = controls + length * 2;
+
+    volume->getBlock(volumes, frames);
+    pan->getBlock(pans, frames);
+    effects->updateBlock(frames);
+    frequency->getBlock(frequencies, frames);
+
+    markUpdated(frames);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        double* frame = gains + i * utils->channels;
+
+        if (frequencies[i] == 0)
+        {
+            memset(frame, 0, sizeof(double) * utils->channels);
+
+            phases[i] = phase->getValue();
+
+            continue;
+        }
+
+        phase->setDelta(utils->twoPi * frequencies[i] / utils->sampleRate);
+        phase->step();
+
+        if (lastVolume == 0 && volumes[i] != 0)
+        {
+            phase->repeat((start + i) * utils->timeStep);
+        }
+
+        lastVolume = volumes[i];
+
+        if (utils->channels == 1)
+        {
+            frame[0] = volumes[i];
+        }
+
+        else
+        {
+            frame[0] = volumes[i] * (1 - pans[i]) / 2;
+            frame[1] = volumes[i] * (pans[i] + 1) / 2;
+        }
+
+        phases[i] = phase->getValue();
+    }
+
+    if (!enabled)
+    {
+        memset(gains, 0, sizeof(double) * frames * utils->channels);
+    }
+}
+
+void Oscillator::generate(double*, const size_t) const
+{
+    // custom waveforms are evaluated a frame at a time by their own
+    // renderBlock and are never banked, so they have no kernel to run
+}
+
+void Oscillator::serialize(Snapshot& snapshot)
+{
+    SingleAudioSource::serialize(snapshot);
+
+    snapshot.object(frequency);
+    snapshot.object(phase);
+
+    snapshot.value(lastVolume);
+}
+
 Sine::Sine(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* frequency) :
     Oscillator(volume, pan, effects, frequency) {}
 
 double Sine::getValue() const
 {
-    return sin(phase->getValue());
+    return Waveform::sine(phase->getValue());
+}
+
+void Sine::generate(double* values, const size_t count) const
+{
+    Waveform::sine(values, count);
 }
 
 Square::Square(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* frequency) :
@@ -136,12 +452,12 @@ Square::Square(ValueObject* volume, ValueObject* pan, ValueObject* effects, Valu
 
 double Square::getValue() const
 {
-    if (sin(phase->getValue()) > 0)
-    {
-        return -1;
-    }
+    return Waveform::square(phase->getValue());
+}
 
-    return 1;
+void Square::generate(double* values, const size_t count) const
+{
+    Waveform::square(values, count);
 }
 
 Saw::Saw(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* frequency) :
@@ -149,7 +465,12 @@ Saw::Saw(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObjec
 
 double Saw::getValue() const
 {
-    return phase->getValue() / utils->pi - 1;
+    return Waveform::saw(phase->getValue());
+}
+
+void Saw::generate(double* values, const size_t count) const
+{
+    Waveform::saw(values, count);
 }
 
 Triangle::Triangle(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* frequency) :
@@ -157,7 +478,12 @@ Triangle::Triangle(ValueObject* volume, ValueObject* pan, ValueObject* effects,
 
 double Triangle::getValue() const
 {
-    return 2 * asin(sin(phase->getValue())) / utils->pi;
+    return Waveform::triangle(phase->getValue());
+}
+
+void Triangle::generate(double* values, const size_t count) const
+{
+    Waveform::triangle(values, count);
 }
 
 CustomOscillator::CustomOscillator(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* frequency, ValueObject* waveform) :
@@ -178,37 +504,197 @@ double CustomOscillator::getValue() const
     return waveform->getValue();
 }
 
+void CustomOscillator::renderBlock(const size_t frames)
+{
+    SingleAudioSource::renderBlock(frames);
+}
+
+bool CustomOscillator::isBankable() const
+{
+    return false;
+}
+
 void CustomOscillator::init()
 {
     volume->start(startTime);
     pan->start(startTime);
-    effects->start(startTime);
+    startEffects();
     frequency->start(startTime);
     waveform->start(startTime);
     phase->start(startTime);
 }
 
+void CustomOscillator::serialize(Snapshot& snapshot)
+{
+    Oscillator::serialize(snapshot);
+
+    snapshot.object(waveform);
+}
+
+OscillatorBank::OscillatorBank(const std::vector<Oscillator*>& oscillators, const std::vector<Utils*>& contexts, const std::vector<size_t>& groups) :
+    oscillators(oscillators), contexts(contexts), groups(groups)
+{
+    // phases are laid out sorted by shape so each waveform kernel runs once
+    // over a contiguous span, while the rows themselves keep their order
+
+    for (size_t i = 0; i < oscillators.size(); i++)
+    {
+        order.push_back(i);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&oscillators](const size_t a, const size_t b)
+    {
+        return std::type_index(typeid(*oscillators[a])) < std::type_index(typeid(*oscillators[b]));
+    });
+
+    slots.resize(oscillators.size());
+
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        slots[order[i]] = i;
+    }
+
+    const Utils* utils = Utils::get();
+
+    phases = (double*)malloc(sizeof(double) * std::max(utils->bufferLength, 1U) * oscillators.size());
+    gains = (double*)malloc(sizeof(double) * std::max(utils->bufferLength, 1U) * utils->channels * oscillators.size());
+}
+
+OscillatorBank::~OscillatorBank()
+{
+    free(phases);
+    free(gains);
+}
+
+void OscillatorBank::renderBlock(double* buffers, const size_t stride, const size_t frame, const size_t frames)
+{
+    const size_t channels = Utils::get()->channels;
+
+    for (size_t row = 0; row < oscillators.size(); row++)
+    {
+        Utils* previous = Utils::set(contexts[row]);
+
+        contexts[row]->setFrame(frame);
+
+        oscillators[row]->prepareBlock(phases + slots[row] * frames, gains + row * frames * channels, frames);
+
+        Utils::set(previous);
+    }
+
+    size_t start = 0;
+
+    for (size_t i = 1; i <= order.size(); i++)
+    {
+        if (i == order.size() || typeid(*oscillators[order[i]]) != typeid(*oscillators[order[start]]))
+        {
+            oscillators[order[start]]->generate(phases + start * frames, (i - start) * frames);
+
+            start = i;
+        }
+    }
+
+    // every row is summed into the buffer of its own group, in the order the
+    // group renders its sources, so the mix does not depend on which groups
+    // share a bank
+
+    for (size_t row = 0; row < oscillators.size(); row++)
+    {
+        double* buffer = buffers + groups[row] * stride;
+
+        if (row == 0 || groups[row] != groups[row - 1])
+        {
+            memset(buffer, 0, sizeof(double) * frames * channels);
+        }
+
+        const double* samples = phases + slots[row] * frames;
+        const double* rowGains = gains + row * frames * channels;
+
+        // the channel count is spelled out so both loops vectorize
+
+        if (channels == 1)
+        {
+            for (size_t i = 0; i < frames; i++)
+            {
+                buffer[i] += rowGains[i] * samples[i];
+            }
+        }
+
+        else
+        {
+            for (size_t i = 0; i < frames; i++)
+            {
+                buffer[i * 2] += rowGains[i * 2] * samples[i];
+                buffer[i * 2 + 1] += rowGains[i * 2 + 1] * samples[i];
+            }
+        }
+    }
+}
+
 Noise::Noise(ValueObject* volume, ValueObject* pan, ValueObject* effects) :
     SingleAudioSource(volume, pan, effects) {}
 
-void Noise::update()
+void Noise::updateInternal()
 {
     volume->update();
     pan->update();
     effects->update();
 
-    const double value = volume->getValue() * udist(utils->rng);
+    random.seek(utils->frame);
+
+    const double value = volume->getValue() * random.uniform(-1, 1);
     const double panValue = pan->getValue();
 
     if (utils->channels == 1)
     {
-        effectBuffer[0] = value;
+        frameBuffer[0] = value;
     }
 
     else
     {
-        effectBuffer[0] = value * (1 - panValue) / 2;
-        effectBuffer[1] = value * (panValue + 1) / 2;
+        frameBuffer[0] = value * (1 - panValue) / 2;
+        frameBuffer[1] = value * (panValue + 1) / 2;
+    }
+}
+
+void Noise::renderBlock(const size_t frames)
+{
+    const size_t start = utils->frame;
+    const size_t length = std::max(utils->bufferLength, 1U);
+
+    double* volumes = controls;
+    double* pans = controls + length;
+
+    volume->getBlock(volumes, frames);
+    pan->getBlock(pans, frames);
+    effects->updateBlock(frames);
+
+    markUpdated(frames);
+
+    if (!enabled)
+    {
+        memset(effectBuffer, 0, sizeof(double) * frames * utils->channels);
+
+        return;
+    }
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        double* frame = effectBuffer + i * utils->channels;
+
+        random.seek(start + i);
+
+        const double value = volumes[i] * random.uniform(-1, 1);
+
+        if (utils->channels == 1)
+        {
+            frame[0] = value;
+        }
+
+        else
+        {
+            frame[0] = value * (1 - pans[i]) / 2;
+            frame[1] = value * (pans[i] + 1) / 2;
+        }
     }
 }
 
@@ -216,7 +702,7 @@ void Noise::init()
 {
     volume->start(startTime);
     pan->start(startTime);
-    effects->start(startTime);
+    startEffects();
 }
 
 Sample::Sample(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* resource) :
@@ -227,7 +713,7 @@ Sample::~Sample()
     delete resource;
 }
 
-void Sample::update()
+void Sample::updateInternal()
 {
     volume->update();
     pan->update();
@@ -241,208 +727,315 @@ void Sample::update()
 
     if (utils->channels == 1)
     {
-        effectBuffer[0] = volumeValue * resourceLeaf->samples[index];
+        frameBuffer[0] = volumeValue * resourceLeaf->samples[index];
     }
 
     else
     {
-        effectBuffer[0] = volumeValue * resourceLeaf->samples[index] * (1 - panValue) / 2;
-        effectBuffer[1] = volumeValue * resourceLeaf->samples[index + 1] * (panValue + 1) / 2;
+        frameBuffer[0] = volumeValue * resourceLeaf->getChannel(0)[index] * (1 - panValue) / 2;
+        frameBuffer[1] = volumeValue * resourceLeaf->getChannel(1)[index] * (panValue + 1) / 2;
     }
 
-    index += utils->channels;
+    index++;
 
-    if (index >= resourceLeaf->length)
+    if (index >= resourceLeaf->frames)
     {
-        index -= resourceLeaf->length;
+        index -= resourceLeaf->frames;
     }
 }
 
-void Sample::init()
+void Sample::renderBlock(const size_t frames)
 {
-    volume->start(startTime);
-    pan->start(startTime);
-    effects->start(startTime);
-    resource->start(startTime);
+    const size_t length = std::max(utils->bufferLength, 1U);
 
-    index = 0;
-}
+    double* volumes = controls;
+    double* pans = controls + length;
 
-double ShapeCoordinator::getValue() const
-{
-    return value;
-}
-
-void ShapeCoordinator::setValue(const double value)
-{
-    this->value = value;
-}
+    volume->getBlock(volumes, frames);
+    pan->getBlock(pans, frames);
+    effects->updateBlock(frames);
+    resource->updateBlock(frames);
 
-Grain::Grain(ValueObject* resource, ValueObject* shape, ShapeCoordinator* coordinator, const size_t length) :
-    resource(resource), shape(shape), coordinator(coordinator), length(length) {}
-
-Grain::~Grain()
-{
-    delete resource;
-    delete shape;
-    delete coordinator;
-}
+    markUpdated(frames);
 
-void Grain::apply(double* buffer)
-{
     const Resource* resourceLeaf = resource->getLeafAs<Resource>();
 
-    const size_t clamped = clampLength(resourceLeaf->length);
+    for (size_t i = 0; i < frames; i++)
+    {
+        double* frame = effectBuffer + i * utils->channels;
 
-    coordinator->setValue((double)(currentIndex - startIndex) / clamped);
+        if (utils->channels == 1)
+        {
+            frame[0] = volumes[i] * resourceLeaf->samples[index];
+        }
 
-    const double shapeValue = shape->getValue();
+        else
+        {
+            frame[0] = volumes[i] * resourceLeaf->getChannel(0)[index] * (1 - pans[i]) / 2;
+            frame[1] = volumes[i] * resourceLeaf->getChannel(1)[index] * (pans[i] + 1) / 2;
+        }
 
-    for (size_t i = 0; i < utils->channels; i++)
-    {
-        buffer[i] += resourceLeaf->samples[currentIndex++] * shapeValue;
+        index++;
+
+        if (index >= resourceLeaf->frames)
+        {
+            index -= resourceLeaf->frames;
+        }
     }
 
-    if (currentIndex >= startIndex + clamped)
+    if (!enabled)
     {
-        stop(0);
+        memset(effectBuffer, 0, sizeof(double) * frames * utils->channels);
     }
 }
 
-void Grain::setLength(const size_t length)
+void Sample::init()
 {
-    this->length = length;
+    volume->start(startTime);
+    pan->start(startTime);
+    startEffects();
+    resource->start(startTime);
+
+    index = 0;
 }
 
-void Grain::init()
+void Sample::skip(const size_t frames)
 {
-    const size_t maxLength = resource->getLeafAs<Resource>()->length;
-    const size_t clamped = clampLength(maxLength);
+    SingleAudioSource::skip(frames);
 
-    currentIndex = randomIndex(maxLength - clamped);
-    startIndex = currentIndex;
+    resource->update();
 
-    if (firstInit)
-    {
-        currentIndex += randomIndex(clamped);
+    const size_t length = resource->getLeafAs<Resource>()->frames;
 
-        firstInit = false;
+    if (length > 0)
+    {
+        index = (index + frames) % length;
     }
 }
 
-size_t Grain::clampLength(const size_t max) const
+void Sample::serialize(Snapshot& snapshot)
 {
-    if (length > max)
-    {
-        return max;
-    }
+    SingleAudioSource::serialize(snapshot);
 
-    return length;
+    snapshot.object(resource);
+
+    snapshot.value(index);
+    snapshot.expect(index < std::max<size_t>(resource->getLeafAs<Resource>()->frames, 1));
 }
 
-size_t Grain::randomIndex(const size_t max) const
+double ShapeCoordinator::getValue() const
 {
-    return (std::uniform_int_distribution<size_t>(0, max)(utils->rng) / utils->channels) * utils->channels;
+    return value;
 }
 
-GrainNode::GrainNode(Grain* grain, GrainNode* prev, GrainNode* next) :
-    grain(grain), prev(prev), next(next) {}
-
-GrainNode::~GrainNode()
+void ShapeCoordinator::setValue(const double value)
 {
-    if (grain)
-    {
-        delete grain;
-    }
+    this->value = value;
 }
 
-GrainList::GrainList()
+void ShapeCoordinator::serialize(Snapshot& snapshot)
 {
-    head->next = tail;
-    tail->prev = head;
+    ValueObject::serialize(snapshot);
+
+    snapshot.value(value);
 }
 
-GrainList::~GrainList()
+GrainPool::GrainPool(RandomStream* random) :
+    random(random) {}
+
+GrainPool::~GrainPool()
 {
-    GrainNode* current = head;
+    free(starts);
+    free(positions);
+    free(lengths);
+    free(active);
+    free(envelope);
+}
 
-    while (current != tail)
+bool GrainPool::spawn(const Resource* resource, const size_t length)
+{
+    if (count == capacity)
     {
-        GrainNode* next = current->next;
+        return false;
+    }
 
-        delete current;
+    const size_t clamped = std::min(length, resource->frames);
 
-        current = next;
-    }
+    starts[count] = random->index(resource->frames - clamped);
+    positions[count] = starts[count] + random->index(clamped);
+    lengths[count] = length;
+    active[count] = true;
+
+    count++;
+    activeLength++;
 
-    delete tail;
+    return true;
 }
 
-void GrainList::append(Grain* grain)
+void GrainPool::tabulate(ValueObject* shape, ShapeCoordinator* coordinator, const size_t length)
 {
-    tail->prev->next = new GrainNode(grain, tail->prev, tail);
-    tail->prev = tail->prev->next;
+    envelopeLength = std::max<size_t>(length, 1);
+    envelope = (double*)realloc(envelope, sizeof(double) * (envelopeLength + 1));
 
-    activeLength++;
-    totalLength++;
+    for (size_t i = 0; i <= envelopeLength; i++)
+    {
+        coordinator->setValue((double)i / envelopeLength);
+
+        envelope[i] = shape->getValue();
+    }
 }
 
-void GrainList::apply(double* buffer, const size_t grainLength, const size_t maxGrains)
+void GrainPool::apply(double* buffer, const Resource* resource, ValueObject* shape, ShapeCoordinator* coordinator, const size_t grainLength, const size_t maxGrains)
 {
-    GrainNode* current = head->next;
+    const Utils* utils = Utils::get();
 
-    while (current != tail)
+    size_t next = 0;
+
+    for (size_t i = 0; i < count; i++)
     {
-        if (activeLength > maxGrains && current->active)
+        if (activeLength > maxGrains && active[i])
         {
-            current->active = false;
+            active[i] = false;
 
             activeLength--;
         }
 
-        current->grain->apply(buffer);
+        const size_t clamped = std::min(lengths[i], resource->frames);
 
-        if (!current->grain->enabled)
+        if (clamped > 0)
         {
-            if (current->active)
+            const double progress = (double)(positions[i] - starts[i]) / clamped;
+
+            double shapeValue;
+
+            if (envelopeLength > 0)
             {
-                current->grain->setLength(grainLength);
-                current->grain->start(utils->time);
+                const double position = progress * envelopeLength;
+                const size_t index = position;
+
+                shapeValue = envelope[index] + (envelope[index + 1] - envelope[index]) * (position - index);
             }
 
             else
             {
-                current->prev->next = current->next;
-                current->next->prev = current->prev;
+                coordinator->setValue(progress);
 
-                totalLength--;
+                shapeValue = shape->getValue();
+            }
 
-                GrainNode* old = current;
+            for (size_t j = 0; j < utils->channels; j++)
+            {
+                buffer[j] += resource->getChannel(j)[positions[i]] * shapeValue;
+            }
 
-                current = current->prev;
+            positions[i]++;
+        }
 
-                delete old;
+        if (positions[i] >= starts[i] + clamped)
+        {
+            if (!active[i])
+            {
+                continue;
             }
+
+            lengths[i] = grainLength;
+            starts[i] = random->index(resource->frames - std::min(grainLength, resource->frames));
+            positions[i] = starts[i];
         }
 
-        current = current->next;
+        if (next != i)
+        {
+            starts[next] = starts[i];
+            positions[next] = positions[i];
+            lengths[next] = lengths[i];
+            active[next] = active[i];
+        }
+
+        next++;
     }
+
+    count = next;
 }
 
-size_t GrainList::getActiveLength() const
+void GrainPool::reserve(const size_t capacity)
 {
-    return activeLength;
+    // the pool never grows while grains are spawned, only when a source is
+    // built or started with more grains than it has room for
+
+    if (capacity <= this->capacity)
+    {
+        return;
+    }
+
+    this->capacity = capacity;
+
+    starts = (size_t*)realloc(starts, sizeof(size_t) * capacity);
+    positions = (size_t*)realloc(positions, sizeof(size_t) * capacity);
+    lengths = (size_t*)realloc(lengths, sizeof(size_t) * capacity);
+    active = (bool*)realloc(active, sizeof(bool) * capacity);
 }
 
-size_t GrainList::getTotalLength() const
+void GrainPool::serialize(Snapshot& snapshot, const Resource* resource)
 {
-    return totalLength;
+    size_t count = this->count;
+    size_t activeLength = this->activeLength;
+
+    snapshot.value(count);
+    snapshot.value(activeLength);
+
+    snapshot.require(count, sizeof(size_t) * 3 + sizeof(bool));
+    snapshot.expect(activeLength <= count);
+
+    reserve(count);
+
+    this->count = count;
+    this->activeLength = activeLength;
+
+    snapshot.bytes(starts, sizeof(size_t) * count);
+    snapshot.bytes(positions, sizeof(size_t) * count);
+    snapshot.bytes(lengths, sizeof(size_t) * count);
+    snapshot.bytes(active, sizeof(bool) * count);
+
+    size_t restored = 0;
+
+    for (size_t i = 0; i < count && snapshot.isRestoring(); i++)
+    {
+        const size_t clamped = std::min(lengths[i], resource->frames);
+
+        snapshot.expect(starts[i] <= resource->frames - clamped && positions[i] >= starts[i] && positions[i] <= starts[i] + clamped);
+
+        restored += active[i];
+    }
+
+    snapshot.expect(!snapshot.isRestoring() || restored == activeLength);
+
+    size_t envelopeLength = this->envelopeLength;
+
+    snapshot.value(envelopeLength);
+    snapshot.require(envelopeLength, sizeof(double));
+
+    if (snapshot.isRestoring() && envelopeLength > 0)
+    {
+        envelope = (double*)realloc(envelope, sizeof(double) * (envelopeLength + 1));
+    }
+
+    this->envelopeLength = envelopeLength;
+
+    if (envelopeLength > 0)
+    {
+        snapshot.bytes(envelope, sizeof(double) * (envelopeLength + 1));
+    }
 }
 
-Granulate::Granulate(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* resource, ValueObject* grains, ValueObject* length, ValueObject* shape) :
-    SingleAudioSource(volume, pan, effects), resource(resource), grains(grains), length(length), shape(shape)
+Granulate::Granulate(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* resource, ValueObject* grains, ValueObject* length, ValueObject* shape, const bool staticShape) :
+    SingleAudioSource(volume, pan, effects), resource(resource), grains(grains), length(length), shape(shape), staticShape(staticShape)
 {
-    shape->getLeafAs<Lambda>()->setInputs({ coordinator });
+    grainPool = new GrainPool(&random);
+
+    if (grains->getRate() == Constants::Constant)
+    {
+        grainPool->reserve(std::max(grains->getValue(), 0.0));
+    }
 }
 
 Granulate::~Granulate()
@@ -452,10 +1045,10 @@ Granulate::~Granulate()
     delete length;
     delete shape;
     delete coordinator;
-    delete grainList;
+    delete grainPool;
 }
 
-void Granulate::update()
+void Granulate::updateInternal()
 {
     volume->start(startTime);
     pan->start(startTime);
@@ -465,63 +1058,97 @@ void Granulate::update()
     length->start(startTime);
     shape->start(startTime);
 
-    memset(effectBuffer, 0, sizeof(double) * utils->channels);
+    memset(frameBuffer, 0, sizeof(double) * utils->channels);
 
-    const size_t lengthValue = utils->sampleRate * utils->channels * length->getValue() / 1000;
+    const size_t lengthValue = utils->sampleRate * length->getValue() / 1000;
     const size_t grainsValue = grains->getValue();
 
-    if (grainList->getActiveLength() < grainsValue)
-    {
-        const size_t count = grainsValue - grainList->getActiveLength();
-
-        for (size_t i = 0; i < count; i++)
-        {
-            Grain* grain = new Grain(resource, shape, coordinator, lengthValue);
+    const Resource* resourceLeaf = resource->getLeafAs<Resource>();
 
-            grain->start(utils->time);
+    // grains past the capacity reserved at start are not spawned
 
-            grainList->append(grain);
+    while (grainPool->getActiveLength() < grainsValue)
+    {
+        if (!grainPool->spawn(resourceLeaf, lengthValue))
+        {
+            break;
         }
     }
 
-    grainList->apply(effectBuffer, lengthValue, grainsValue);
+    grainPool->apply(frameBuffer, resourceLeaf, shape, coordinator, lengthValue, grainsValue);
 
-    const double volumeValue = volume->getValue() / fmax(1.3 * sqrt(grainList->getTotalLength()), 1);
+    const double volumeValue = volume->getValue() / fmax(1.3 * sqrt(grainPool->getTotalLength()), 1);
 
     for (size_t i = 0; i < utils->channels; i++)
     {
-        effectBuffer[i] *= volumeValue;
+        frameBuffer[i] *= volumeValue;
     }
 
     const double panValue = pan->getValue();
 
     if (utils->channels == 2)
     {
-        effectBuffer[0] = effectBuffer[0] * (1 - panValue) / 2;
-        effectBuffer[1] = effectBuffer[1] * (1 + panValue) / 2;
+        frameBuffer[0] = frameBuffer[0] * (1 - panValue) / 2;
+        frameBuffer[1] = frameBuffer[1] * (1 + panValue) / 2;
     }
 }
 
+bool Granulate::isSkippable() const
+{
+    // grains spawn and finish throughout the skipped time, so they are
+    // stepped through it rather than restarted at the target
+
+    return false;
+}
+
 void Granulate::init()
 {
     volume->start(startTime);
     pan->start(startTime);
-    effects->start(startTime);
+    startEffects();
     resource->start(startTime);
     grains->start(startTime);
     length->start(startTime);
     shape->start(startTime);
+    coordinator->start(startTime);
+
+    shape->getLeafAs<Lambda>()->setInputs({ coordinator });
+
+    grainPool->reserve(std::max(grains->getValue(), 0.0));
+
+    // a static shape is tabulated once at a fixed resolution, grains of any
+    // length interpolate between its points
+
+    if (staticShape && !grainPool->isTabulated())
+    {
+        grainPool->tabulate(shape, coordinator, shapeResolution);
+    }
+}
+
+void Granulate::serialize(Snapshot& snapshot)
+{
+    SingleAudioSource::serialize(snapshot);
+
+    snapshot.object(resource);
+    snapshot.object(grains);
+    snapshot.object(length);
+    snapshot.object(shape);
+    snapshot.object(coordinator);
+
+    snapshot.random(random);
+
+    grainPool->serialize(snapshot, resource->getLeafAs<Resource>());
 }
 
 Group::Group(ValueObject* volume, ValueObject* pan, ValueObject* effects, ValueObject* sources) :
     volume(volume), pan(pan), effects(effects), sources(sources)
 {
-    effectBuffer = (double*)malloc(sizeof(double) * utils->channels);
+    effectBuffer = (double*)Arena::acquire(sizeof(double) * utils->channels);
 }
 
 Group::~Group()
 {
-    free(effectBuffer);
+    Arena::release(effectBuffer);
 
     delete volume;
     delete pan;
@@ -576,3 +1203,13 @@ void Group::init()
     effects->start(startTime);
     sources->start(startTime);
 }
+
+void Group::serialize(Snapshot& snapshot)
+{
+    AudioSource::serialize(snapshot);
+
+    snapshot.object(volume);
+    snapshot.object(pan);
+    snapshot.object(effects);
+    snapshot.object(sources);
+}
@@ -0,0 +1,202 @@
+#include "../include/cache.h"
+
+#if defined(_WIN32)
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace Engine;
+
+MappedFile::MappedFile(const Path& path)
+{
+#if defined(_WIN32)
+    file = CreateFileA(path.string().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    LARGE_INTEGER fileSize;
+
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        return;
+    }
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+
+    if (!mapping)
+    {
+        return;
+    }
+
+    data = (char*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    size = data ? fileSize.QuadPart : 0;
+#else
+    const int descriptor = open(path.string().c_str(), O_RDONLY);
+
+    if (descriptor < 0)
+    {
+        return;
+    }
+
+    struct stat status;
+
+    if (fstat(descriptor, &status) == 0 && status.st_size > 0)
+    {
+        void* pointer = mmap(nullptr, status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+
+        if (pointer != MAP_FAILED)
+        {
+            data = (char*)pointer;
+            size = status.st_size;
+        }
+    }
+
+    close(descriptor);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(_WIN32)
+    if (data)
+    {
+        UnmapViewOfFile(data);
+    }
+
+    if (mapping)
+    {
+        CloseHandle(mapping);
+    }
+
+    if (file && file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file);
+    }
+#else
+    if (data)
+    {
+        munmap(data, size);
+    }
+#endif
+}
+
+ResourceCache::ResourceCache(const Path& directory, const Path& source, const unsigned int sampleRate, const unsigned int channels) :
+    channels(channels)
+{
+    const std::string name = std::filesystem::absolute(source.string()).string();
+
+    key = 14695981039346656037ull;
+
+    for (const char c : name)
+    {
+        key = (key ^ (unsigned char)c) * 1099511628211ull;
+    }
+
+    const uint64_t size = std::filesystem::file_size(source.string());
+
+    const uint64_t values[] = { size, (uint64_t)std::filesystem::last_write_time(source.string()).time_since_epoch().count(), sampleRate, channels, version };
+
+    for (const uint64_t value : values)
+    {
+        key = (key ^ value) * 1099511628211ull;
+    }
+
+    // the key only covers metadata, so the start, middle and end of the audio
+    // file are hashed as well to catch rewrites that keep its size and
+    // modification time, without reading all of a long file on every hit
+
+    std::ifstream input(source.string(), std::ios::binary);
+
+    std::vector<char> buffer(digestLength);
+
+    digest = 14695981039346656037ull;
+
+    const uint64_t offsets[] = { 0, size > digestLength ? (size - digestLength) / 2 : 0, size > digestLength ? size - digestLength : 0 };
+
+    for (const uint64_t offset : offsets)
+    {
+        input.clear();
+        input.seekg(offset);
+        input.read(buffer.data(), digestLength);
+
+        for (std::streamsize i = 0; i < input.gcount(); i++)
+        {
+            digest = (digest ^ (unsigned char)buffer[i]) * 1099511628211ull;
+        }
+
+        if (size <= digestLength)
+        {
+            break;
+        }
+    }
+
+    char file[32];
+
+    snprintf(file, sizeof(file), "%016llx.cache", (unsigned long long)key);
+
+    path = (std::filesystem::path(directory.string()) / file).string();
+}
+
+MappedFile* ResourceCache::load(float*& samples, size_t& frames) const
+{
+    if (!std::filesystem::is_regular_file(path))
+    {
+        return nullptr;
+    }
+
+    MappedFile* file = new MappedFile(Path::relative(path));
+
+    if (file->getSize() >= sizeof(Header))
+    {
+        const Header* header = (const Header*)file->getData();
+
+        if (header->magic == magic && header->version == version && header->key == key && header->digest == digest && file->getSize() == sizeof(Header) + sizeof(float) * header->frames * channels)
+        {
+            samples = (float*)(file->getData() + sizeof(Header));
+            frames = header->frames;
+
+            return file;
+        }
+    }
+
+    delete file;
+
+    return nullptr;
+}
+
+void ResourceCache::store(const float* samples, const size_t frames) const
+{
+#if defined(_WIN32)
+    const std::string temporary = path + "." + std::to_string(GetCurrentProcessId()) + ".tmp";
+#else
+    const std::string temporary = path + "." + std::to_string(getpid()) + ".tmp";
+#endif
+
+    std::ofstream file(temporary, std::ios::binary);
+
+    const Header header = { magic, version, key, digest, frames };
+
+    file.write((const char*)&header, sizeof(Header));
+    file.write((const char*)samples, sizeof(float) * frames * channels);
+
+    file.close();
+
+    std::error_code error;
+
+    if (!file.fail())
+    {
+        std::filesystem::rename(temporary, path, error);
+
+        if (!error)
+        {
+            return;
+        }
+    }
+
+    std::filesystem::remove(temporary, error);
+
+    Utils::printWarning("Could not write cache file \"" + path + "\".");
+}
@@ -7,6 +7,21 @@ double Time::getValue() const
     return utils->time;
 }
 
+size_t Time::getBlock(double* values, const size_t frames)
+{
+    for (size_t i = 0; i < frames; i++)
+    {
+        values[i] = i > 0 ? (utils->frame + i) * utils->timeStep : utils->time;
+    }
+
+    return enabled ? frames : 0;
+}
+
+Constants::Rate Time::getRate() const
+{
+    return Constants::Control;
+}
+
 Value::Value(const double value) :
     value(value) {}
 
@@ -15,6 +30,23 @@ double Value::getValue() const
     return value;
 }
 
+size_t Value::getBlock(double* values, const size_t frames)
+{
+    std::fill(values, values + frames, value);
+
+    return enabled ? frames : 0;
+}
+
+Constants::Rate Value::getRate() const
+{
+    return Constants::Constant;
+}
+
+double Value::getMaximum() const
+{
+    return value;
+}
+
 ValueChar::ValueChar(const unsigned char value) :
     value(value) {}
 
@@ -36,7 +68,34 @@ double ValueNegate::getValue() const
     return -value->getValue();
 }
 
-void ValueNegate::update()
+size_t ValueNegate::getBlock(double* values, const size_t frames)
+{
+    const size_t active = value->getBlock(values, frames);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        values[i] = -values[i];
+    }
+
+    return finishBlock(value, values, active, frames);
+}
+
+Constants::Rate ValueNegate::getRate() const
+{
+    return value->getRate();
+}
+
+double ValueNegate::getMaximum() const
+{
+    if (getRate() == Constants::Constant)
+    {
+        return -value->getMaximum();
+    }
+
+    return std::numeric_limits<double>::infinity();
+}
+
+void ValueNegate::updateInternal()
 {
     value->update();
 
@@ -51,6 +110,82 @@ void ValueNegate::init()
     value->start(startTime);
 }
 
+void ValueNegate::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(value);
+}
+
+ValueSquare::ValueSquare(ValueObject* value) :
+    value(value) {}
+
+ValueSquare::~ValueSquare()
+{
+    delete value;
+}
+
+double ValueSquare::getValue() const
+{
+    if (!enabled)
+    {
+        return 0;
+    }
+
+    const double value = this->value->getValue();
+
+    return value * value;
+}
+
+size_t ValueSquare::getBlock(double* values, const size_t frames)
+{
+    const size_t active = value->getBlock(values, frames);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        values[i] *= values[i];
+    }
+
+    return finishBlock(value, values, active, frames);
+}
+
+Constants::Rate ValueSquare::getRate() const
+{
+    return value->getRate();
+}
+
+double ValueSquare::getMaximum() const
+{
+    if (getRate() == Constants::Constant)
+    {
+        return value->getMaximum() * value->getMaximum();
+    }
+
+    return std::numeric_limits<double>::infinity();
+}
+
+void ValueSquare::updateInternal()
+{
+    value->update();
+
+    if (!value->enabled)
+    {
+        stop(value->getStopTime());
+    }
+}
+
+void ValueSquare::init()
+{
+    value->start(startTime);
+}
+
+void ValueSquare::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(value);
+}
+
 ValueCombination::ValueCombination(ValueObject* value1, ValueObject* value2) :
     value1(value1), value2(value2) {}
 
@@ -70,7 +205,81 @@ double ValueCombination::getValue() const
     return getValueInternal(value1->getValue(), value2->getValue());
 }
 
-void ValueCombination::update()
+size_t ValueCombination::getBlock(double* values, const size_t frames)
+{
+    const size_t start = utils->frame;
+
+    double values2[chunkLength];
+
+    size_t active = frames;
+
+    ValueObject* stopped = value1;
+
+    for (size_t offset = 0; offset < frames; offset += chunkLength)
+    {
+        const size_t length = std::min(chunkLength, frames - offset);
+
+        if (offset > 0)
+        {
+            utils->setFrame(start + offset);
+        }
+
+        const size_t active1 = value1->getBlock(values + offset, length);
+        const size_t active2 = value2->getBlock(values2, length);
+
+        getBlockInternal(values + offset, values2, length);
+
+        if (active == frames && std::min(active1, active2) < length)
+        {
+            active = offset + std::min(active1, active2);
+            stopped = active1 <= active2 ? value1 : value2;
+        }
+    }
+
+    if (frames > chunkLength)
+    {
+        utils->setFrame(start);
+    }
+
+    return finishBlock(stopped, values, active, frames);
+}
+
+void ValueCombination::getBlockInternal(double* values1, const double* values2, const size_t frames) const
+{
+    for (size_t i = 0; i < frames; i++)
+    {
+        values1[i] = getValueInternal(values1[i], values2[i]);
+    }
+}
+
+double ValueCombination::getMaximumInternal(const double, const double) const
+{
+    return std::numeric_limits<double>::infinity();
+}
+
+Constants::Rate ValueCombination::getRate() const
+{
+    return std::max(value1->getRate(), value2->getRate());
+}
+
+double ValueCombination::getMaximum() const
+{
+    // the maximum of a constant is its value, so constant combinations are
+    // evaluated directly and only operations that preserve an upper bound
+    // give one otherwise
+
+    const double maximum1 = value1->getMaximum();
+    const double maximum2 = value2->getMaximum();
+
+    if (getRate() == Constants::Constant)
+    {
+        return getValueInternal(maximum1, maximum2);
+    }
+
+    return getMaximumInternal(maximum1, maximum2);
+}
+
+void ValueCombination::updateInternal()
 {
     value1->update();
     value2->update();
@@ -92,6 +301,14 @@ void ValueCombination::init()
     value2->start(startTime);
 }
 
+void ValueCombination::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(value1);
+    snapshot.object(value2);
+}
+
 ValueAdd::ValueAdd(ValueObject* value1, ValueObject* value2) :
     ValueCombination(value1, value2) {}
 
@@ -100,6 +317,19 @@ double ValueAdd::getValueInternal(const double value1, const double value2) cons
     return value1 + value2;
 }
 
+void ValueAdd::getBlockInternal(double* values1, const double* values2, const size_t frames) const
+{
+    for (size_t i = 0; i < frames; i++)
+    {
+        values1[i] += values2[i];
+    }
+}
+
+double ValueAdd::getMaximumInternal(const double maximum1, const double maximum2) const
+{
+    return maximum1 + maximum2;
+}
+
 ValueSubtract::ValueSubtract(ValueObject* value1, ValueObject* value2) :
     ValueCombination(value1, value2) {}
 
@@ -108,6 +338,14 @@ double ValueSubtract::getValueInternal(const double value1, const double value2)
     return value1 - value2;
 }
 
+void ValueSubtract::getBlockInternal(double* values1, const double* values2, const size_t frames) const
+{
+    for (size_t i = 0; i < frames; i++)
+    {
+        values1[i] -= values2[i];
+    }
+}
+
 ValueMultiply::ValueMultiply(ValueObject* value1, ValueObject* value2) :
     ValueCombination(value1, value2) {}
 
@@ -116,6 +354,14 @@ double ValueMultiply::getValueInternal(const double value1, const double value2)
     return value1 * value2;
 }
 
+void ValueMultiply::getBlockInternal(double* values1, const double* values2, const size_t frames) const
+{
+    for (size_t i = 0; i < frames; i++)
+    {
+        values1[i] *= values2[i];
+    }
+}
+
 ValueDivide::ValueDivide(ValueObject* value1, ValueObject* value2) :
     ValueCombination(value1, value2) {}
 
@@ -124,6 +370,14 @@ double ValueDivide::getValueInternal(const double value1, const double value2) c
     return value1 / value2;
 }
 
+void ValueDivide::getBlockInternal(double* values1, const double* values2, const size_t frames) const
+{
+    for (size_t i = 0; i < frames; i++)
+    {
+        values1[i] /= values2[i];
+    }
+}
+
 ValuePower::ValuePower(ValueObject* value1, ValueObject* value2) :
     ValueCombination(value1, value2) {}
 
@@ -198,7 +452,7 @@ double All::getValue() const
     return 1;
 }
 
-void All::update()
+void All::updateInternal()
 {
     values->update();
 
@@ -232,6 +486,13 @@ void All::init()
     }
 }
 
+void All::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(values);
+}
+
 Any::Any(ValueObject* values) :
     values(values) {}
 
@@ -258,7 +519,7 @@ double Any::getValue() const
     return 0;
 }
 
-void Any::update()
+void Any::updateInternal()
 {
     values->update();
 
@@ -292,6 +553,13 @@ void Any::init()
     }
 }
 
+void Any::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(values);
+}
+
 None::None(ValueObject* values) :
     values(values) {}
 
@@ -318,7 +586,7 @@ double None::getValue() const
     return 1;
 }
 
-void None::update()
+void None::updateInternal()
 {
     values->update();
 
@@ -352,6 +620,13 @@ void None::init()
     }
 }
 
+void None::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(values);
+}
+
 Min::Min(ValueObject* values) :
     values(values) {}
 
@@ -382,7 +657,7 @@ double Min::getValue() const
     return min;
 }
 
-void Min::update()
+void Min::updateInternal()
 {
     values->update();
 
@@ -416,6 +691,13 @@ void Min::init()
     }
 }
 
+void Min::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(values);
+}
+
 Max::Max(ValueObject* values) :
     values(values) {}
 
@@ -446,7 +728,7 @@ double Max::getValue() const
     return max;
 }
 
-void Max::update()
+void Max::updateInternal()
 {
     values->update();
 
@@ -480,6 +762,13 @@ void Max::init()
     }
 }
 
+void Max::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(values);
+}
+
 Round::Round(ValueObject* value, ValueObject* step, ValueObject* direction) :
     value(value), step(step), direction(direction) {}
 
@@ -520,7 +809,7 @@ double Round::getValue() const
     return 0;
 }
 
-void Round::update()
+void Round::updateInternal()
 {
     value->update();
     step->update();
@@ -539,6 +828,15 @@ void Round::init()
     direction->start(startTime);
 }
 
+void Round::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(value);
+    snapshot.object(step);
+    snapshot.object(direction);
+}
+
 Absolute::Absolute(ValueObject* value) :
     value(value) {}
 
@@ -557,7 +855,7 @@ double Absolute::getValue() const
     return fabs(value->getValue());
 }
 
-void Absolute::update()
+void Absolute::updateInternal()
 {
     value->update();
 
@@ -572,6 +870,106 @@ void Absolute::init()
     value->start(startTime);
 }
 
+void Absolute::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(value);
+}
+
+ControlRate::ControlRate(ValueObject* value, const size_t period) :
+    value(value), period(period) {}
+
+ControlRate::~ControlRate()
+{
+    delete value;
+}
+
+double ControlRate::getValue() const
+{
+    if (!enabled)
+    {
+        return 0;
+    }
+
+    return current;
+}
+
+Constants::Rate ControlRate::getRate() const
+{
+    return Constants::Control;
+}
+
+double ControlRate::getMaximum() const
+{
+    return value->getMaximum();
+}
+
+void ControlRate::updateInternal()
+{
+    // the child is only updated on control ticks, so a stop or retrigger is
+    // noticed up to period - 1 frames late, the stop time itself is exact
+
+    if (step == 0)
+    {
+        value->update();
+
+        if (!value->enabled)
+        {
+            stop(value->getStopTime());
+
+            return;
+        }
+
+        // a repeat or the next controller of a sequence restarts the leaf, so
+        // the ramp jumps to the new event instead of smoothing over the edge
+
+        const ValueObject* leaf = value->getLeaf();
+        const double eventTime = leaf ? leaf->getStartTime() : 0;
+
+        target = value->getValue();
+        previous = resetting || eventTime != event ? target : current;
+
+        event = eventTime;
+
+        resetting = false;
+    }
+
+    step++;
+
+    current = previous + (target - previous) * step / period;
+
+    if (step == period)
+    {
+        step = 0;
+    }
+}
+
+void ControlRate::init()
+{
+    value->start(startTime);
+
+    step = 0;
+
+    resetting = true;
+}
+
+void ControlRate::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(value);
+
+    snapshot.value(step);
+    snapshot.expect(step < period);
+
+    snapshot.value(resetting);
+    snapshot.value(event);
+    snapshot.value(previous);
+    snapshot.value(target);
+    snapshot.value(current);
+}
+
 Sequence::Sequence(ValueObject* controllers, ValueObject* order) :
     controllers(controllers), order(order) {}
 
@@ -591,6 +989,44 @@ double Sequence::getValue() const
     return controllers->getLeafAs<List>()->objects[current]->getValue();
 }
 
+Constants::Rate Sequence::getRate() const
+{
+    const List* list = dynamic_cast<const List*>(controllers);
+
+    if (!list)
+    {
+        return Constants::Audio;
+    }
+
+    Constants::Rate rate = Constants::Control;
+
+    for (const ValueObject* object : list->objects)
+    {
+        rate = std::max(rate, object->getRate());
+    }
+
+    return rate;
+}
+
+double Sequence::getMaximum() const
+{
+    const List* list = dynamic_cast<const List*>(controllers);
+
+    if (!list)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double maximum = -std::numeric_limits<double>::infinity();
+
+    for (const ValueObject* object : list->objects)
+    {
+        maximum = std::max(maximum, object->getMaximum());
+    }
+
+    return maximum;
+}
+
 ValueObject* Sequence::getLeaf()
 {
     if (!enabled)
@@ -601,7 +1037,7 @@ ValueObject* Sequence::getLeaf()
     return controllers->getLeafAs<List>()->objects[current]->getLeaf();
 }
 
-void Sequence::update()
+void Sequence::updateInternal()
 {
     controllers->update();
     order->update();
@@ -650,8 +1086,6 @@ void Sequence::init()
 
     chosen.clear();
 
-    udist = std::uniform_int_distribution<size_t>(0, objects.size() - 1);
-
     switch (order->getLeafAs<ValueChar>()->value)
     {
         case Constants::Sequence::Backward:
@@ -660,7 +1094,7 @@ void Sequence::init()
             break;
 
         case Constants::Sequence::Shuffle:
-            current = udist(utils->rng);
+            current = random.index(objects.size() - 1);
 
             if (current == last)
             {
@@ -707,7 +1141,7 @@ void Sequence::reinit()
         case Constants::Sequence::Shuffle:
             if (chosen.size() < objects.size())
             {
-                current = udist(utils->rng);
+                current = random.index(objects.size() - 1);
 
                 while (chosen.count(current))
                 {
@@ -723,6 +1157,55 @@ void Sequence::reinit()
     objects[current]->start(repeatTime);
 }
 
+void Sequence::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(controllers);
+    snapshot.object(order);
+
+    // a sequence that has not started yet may hold no controllers
+
+    const size_t size = std::max<size_t>(controllers->getLeafAs<List>()->objects.size(), 1);
+
+    snapshot.value(current);
+    snapshot.value(direction);
+    snapshot.value(last);
+    snapshot.value(switches);
+
+    snapshot.expect(current < size && (last < size || last == (size_t)-1));
+
+    snapshot.random(random);
+
+    size_t count = chosen.size();
+
+    snapshot.value(count);
+    snapshot.require(count, sizeof(size_t));
+
+    if (snapshot.isRestoring())
+    {
+        chosen.clear();
+
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t index;
+
+            snapshot.value(index);
+            snapshot.expect(index < size);
+
+            chosen.insert(index);
+        }
+    }
+
+    else
+    {
+        for (size_t index : chosen)
+        {
+            snapshot.value(index);
+        }
+    }
+}
+
 Repeat::Repeat(ValueObject* value, ValueObject* repeats) :
     value(value), repeats(repeats) {}
 
@@ -742,6 +1225,16 @@ double Repeat::getValue() const
     return value->getValue();
 }
 
+Constants::Rate Repeat::getRate() const
+{
+    return std::max({ Constants::Control, value->getRate(), repeats->getRate() });
+}
+
+double Repeat::getMaximum() const
+{
+    return value->getMaximum();
+}
+
 ValueObject* Repeat::getLeaf()
 {
     if (!enabled)
@@ -752,7 +1245,7 @@ ValueObject* Repeat::getLeaf()
     return value->getLeaf();
 }
 
-void Repeat::update()
+void Repeat::updateInternal()
 {
     value->update();
     repeats->update();
@@ -787,6 +1280,16 @@ void Repeat::reinit()
     repeats->start(startTime);
 }
 
+void Repeat::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(value);
+    snapshot.object(repeats);
+
+    snapshot.value(times);
+}
+
 Hold::Hold(ValueObject* value, ValueObject* length) :
     value(value), length(length) {}
 
@@ -806,6 +1309,16 @@ double Hold::getValue() const
     return value->getValue();
 }
 
+Constants::Rate Hold::getRate() const
+{
+    return std::max({ Constants::Control, value->getRate(), length->getRate() });
+}
+
+double Hold::getMaximum() const
+{
+    return value->getMaximum();
+}
+
 ValueObject* Hold::getLeaf()
 {
     if (!enabled)
@@ -816,7 +1329,7 @@ ValueObject* Hold::getLeaf()
     return value;
 }
 
-void Hold::update()
+void Hold::updateInternal()
 {
     value->update();
     length->update();
@@ -835,6 +1348,14 @@ void Hold::init()
     length->start(startTime);
 }
 
+void Hold::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(value);
+    snapshot.object(length);
+}
+
 Sweep::Sweep(ValueObject* from, ValueObject* to, ValueObject* length) :
     from(from), to(to), length(length) {}
 
@@ -859,7 +1380,17 @@ double Sweep::getValue() const
     return fromValue + (toValue - fromValue) * (utils->time - startTime) / lengthValue;
 }
 
-void Sweep::update()
+Constants::Rate Sweep::getRate() const
+{
+    return std::max({ Constants::Control, from->getRate(), to->getRate(), length->getRate() });
+}
+
+double Sweep::getMaximum() const
+{
+    return std::max(from->getMaximum(), to->getMaximum());
+}
+
+void Sweep::updateInternal()
 {
     from->update();
     to->update();
@@ -880,6 +1411,15 @@ void Sweep::init()
     length->start(startTime);
 }
 
+void Sweep::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(from);
+    snapshot.object(to);
+    snapshot.object(length);
+}
+
 LFO::LFO(ValueObject* from, ValueObject* to, ValueObject* length) :
     from(from), to(to), length(length) {}
 
@@ -904,7 +1444,17 @@ double LFO::getValue() const
     return fromValue + (toValue - fromValue) * (-cos(utils->twoPi * (utils->time - startTime) / lengthValue) / 2 + 0.5);
 }
 
-void LFO::update()
+Constants::Rate LFO::getRate() const
+{
+    return std::max({ Constants::Control, from->getRate(), to->getRate(), length->getRate() });
+}
+
+double LFO::getMaximum() const
+{
+    return std::max(from->getMaximum(), to->getMaximum());
+}
+
+void LFO::updateInternal()
 {
     from->update();
     to->update();
@@ -925,6 +1475,15 @@ void LFO::init()
     length->start(startTime);
 }
 
+void LFO::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(from);
+    snapshot.object(to);
+    snapshot.object(length);
+}
+
 Random::Random(ValueObject* from, ValueObject* to, ValueObject* length, ValueObject* type) :
     from(from), to(to), length(length), type(type) {}
 
@@ -955,7 +1514,17 @@ double Random::getValue() const
     return 0;
 }
 
-void Random::update()
+Constants::Rate Random::getRate() const
+{
+    return std::max({ Constants::Control, from->getRate(), to->getRate(), length->getRate() });
+}
+
+double Random::getMaximum() const
+{
+    return std::max(from->getMaximum(), to->getMaximum());
+}
+
+void Random::updateInternal()
 {
     from->update();
     to->update();
@@ -977,11 +1546,12 @@ void Random::init()
     length->start(startTime);
     type->start(startTime);
 
-    std::uniform_real_distribution<> udist(from->getValue(), to->getValue());
+    const double fromValue = from->getValue();
+    const double toValue = to->getValue();
 
     if (first)
     {
-        current = udist(utils->rng);
+        current = random.uniform(fromValue, toValue);
     }
 
     else
@@ -989,11 +1559,27 @@ void Random::init()
         current = next;
     }
 
-    next = udist(utils->rng);
+    next = random.uniform(fromValue, toValue);
 
     first = false;
 }
 
+void Random::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(from);
+    snapshot.object(to);
+    snapshot.object(length);
+    snapshot.object(type);
+
+    snapshot.value(current);
+    snapshot.value(next);
+    snapshot.value(first);
+
+    snapshot.random(random);
+}
+
 Limit::Limit(ValueObject* value, ValueObject* min, ValueObject* max) :
     value(value), min(min), max(max) {}
 
@@ -1028,7 +1614,17 @@ double Limit::getValue() const
     return valueValue;
 }
 
-void Limit::update()
+Constants::Rate Limit::getRate() const
+{
+    return std::max({ value->getRate(), min->getRate(), max->getRate() });
+}
+
+double Limit::getMaximum() const
+{
+    return std::min(value->getMaximum(), max->getMaximum());
+}
+
+void Limit::updateInternal()
 {
     value->update();
     min->update();
@@ -1047,6 +1643,15 @@ void Limit::init()
     max->start(startTime);
 }
 
+void Limit::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(value);
+    snapshot.object(min);
+    snapshot.object(max);
+}
+
 Trigger::Trigger(ValueObject* condition, ValueObject* value) :
     condition(condition), value(value) {}
 
@@ -1076,7 +1681,7 @@ ValueObject* Trigger::getLeaf()
     return value->getLeaf();
 }
 
-void Trigger::update()
+void Trigger::updateInternal()
 {
     if (triggered)
     {
@@ -1114,6 +1719,16 @@ void Trigger::init()
     condition->start(startTime);
 }
 
+void Trigger::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(condition);
+    snapshot.object(value);
+
+    snapshot.value(triggered);
+}
+
 If::If(ValueObject* condition, ValueObject* trueValue, ValueObject* falseValue) :
     condition(condition), trueValue(trueValue), falseValue(falseValue) {}
 
@@ -1149,7 +1764,7 @@ ValueObject* If::getLeaf()
     return trueValue->getLeaf();
 }
 
-void If::update()
+void If::updateInternal()
 {
     condition->update();
     trueValue->update();
@@ -1167,3 +1782,12 @@ void If::init()
     trueValue->start(startTime);
     falseValue->start(startTime);
 }
+
+void If::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(condition);
+    snapshot.object(trueValue);
+    snapshot.object(falseValue);
+}
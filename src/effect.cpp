@@ -4,11 +4,60 @@ using namespace Engine;
 
 void Effect::apply(double* buffer) {}
 
+double Effect::getTail()
+{
+    return 0;
+}
+
+double Effect::getFeedbackTail(const double delay, const double feedback)
+{
+    const double gain = fabs(feedback);
+
+    if (gain == 0)
+    {
+        return delay;
+    }
+
+    return delay * std::min(log(0.001) / log(std::min(gain, 0.999)), 100.0);
+}
+
+double Effect::getMaxDelay(const ValueObject* delay)
+{
+    // delays get exactly the room for the largest value their expression can
+    // reach, an expression with no known bound gets room for unboundedDelay
+    // and reads any longer delay from the oldest frame held
+
+    const double maximum = delay->getMaximum();
+
+    if (!std::isfinite(maximum))
+    {
+        return DelayBuffer::unboundedDelay;
+    }
+
+    return std::clamp(maximum, 0.0, DelayBuffer::maxDelay);
+}
+
+void Effect::applyBlock(double* buffer, const size_t frames)
+{
+    const size_t start = utils->frame;
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        utils->setFrame(start + i);
+
+        update();
+        apply(buffer + i * utils->channels);
+    }
+
+    utils->setFrame(start);
+}
+
 EffectGroup::EffectGroup(ValueObject* mix, ValueObject* effects) :
     mix(mix), effects(effects)
 {
-    original = (double*)malloc(sizeof(double) * utils->channels);
-    applied = (double*)malloc(sizeof(double) * utils->channels);
+    original = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U) * utils->channels);
+    applied = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U) * utils->channels);
+    controls = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U));
 }
 
 EffectGroup::~EffectGroup()
@@ -16,8 +65,9 @@ EffectGroup::~EffectGroup()
     delete mix;
     delete effects;
 
-    free(original);
-    free(applied);
+    Arena::release(original);
+    Arena::release(applied);
+    Arena::release(controls);
 }
 
 void EffectGroup::apply(double* buffer)
@@ -47,51 +97,163 @@ void EffectGroup::apply(double* buffer)
     }
 }
 
+void EffectGroup::applyBlock(double* buffer, const size_t frames)
+{
+    const size_t length = frames * utils->channels;
+
+    memcpy(original, buffer, sizeof(double) * length);
+    memset(buffer, 0, sizeof(double) * length);
+
+    const std::vector<ValueObject*>& effectObjects = effects->getLeafAs<List>()->objects;
+
+    for (ValueObject* effect : effectObjects)
+    {
+        memcpy(applied, original, sizeof(double) * length);
+
+        static_cast<Effect*>(effect)->applyBlock(applied, frames);
+
+        for (size_t i = 0; i < length; i++)
+        {
+            buffer[i] += applied[i] / effectObjects.size();
+        }
+    }
+
+    mix->getBlock(controls, frames);
+    effects->updateBlock(frames);
+
+    markUpdated(frames);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        const double mixValue = controls[i];
+
+        for (size_t j = i * utils->channels; j < (i + 1) * utils->channels; j++)
+        {
+            buffer[j] = original[j] * (1 - mixValue) + buffer[j] * mixValue;
+        }
+    }
+}
+
+double EffectGroup::getTail()
+{
+    double tail = 0;
+
+    for (ValueObject* effect : effects->getLeafAs<List>()->objects)
+    {
+        tail = std::max(tail, static_cast<Effect*>(effect)->getTail());
+    }
+
+    return tail;
+}
+
+void EffectGroup::updateInternal()
+{
+    mix->update();
+    effects->update();
+
+    for (ValueObject* effect : effects->getLeafAs<List>()->objects)
+    {
+        effect->update();
+    }
+}
+
 void EffectGroup::init()
 {
     mix->start(startTime);
     effects->start(startTime);
+
+    for (ValueObject* effect : effects->getLeafAs<List>()->objects)
+    {
+        effect->start(startTime);
+    }
+}
+
+void EffectGroup::serialize(Snapshot& snapshot)
+{
+    Effect::serialize(snapshot);
+
+    snapshot.object(mix);
+    snapshot.object(effects);
 }
 
 Delay::Delay(ValueObject* mix, ValueObject* delay, ValueObject* feedback) :
-    mix(mix), delay(delay), feedback(feedback) {}
+    mix(mix), delay(delay), feedback(feedback)
+{
+    delayBuffer = new DelayBuffer(utils->sampleRate * getMaxDelay(delay) / 1000);
+
+    controls = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U) * 3);
+}
 
 Delay::~Delay()
 {
     delete mix;
     delete delay;
     delete feedback;
+
+    delete delayBuffer;
+
+    Arena::release(controls);
 }
 
 void Delay::apply(double* buffer)
 {
-    const size_t delayFrames = utils->channels * utils->sampleRate * delay->getValue() / 1000;
+    applyFrame(buffer, mix->getValue(), delay->getValue(), feedback->getValue());
+}
+
+void Delay::applyBlock(double* buffer, const size_t frames)
+{
+    const size_t length = std::max(utils->bufferLength, 1U);
 
-    while (delayBuffer.size() > delayFrames)
+    mix->getBlock(controls, frames);
+    delay->getBlock(controls + length, frames);
+    feedback->getBlock(controls + length * 2, frames);
+
+    markUpdated(frames);
+
+    for (size_t i = 0; i < frames; i++)
     {
-        delayBuffer.pop();
+        applyFrame(buffer + i * utils->channels, controls[i], controls[length + i], controls[length * 2 + i]);
     }
+}
 
-    const double mixValue = mix->getValue();
-    const double feedbackValue = feedback->getValue();
+void Delay::applyFrame(double* buffer, const double mixValue, const double delayValue, const double feedbackValue)
+{
+    const double delayFrames = utils->sampleRate * delayValue / 1000;
 
-    for (size_t i = 0; i < utils->channels; i++)
+    if (delayFrames < 1)
     {
-        if (delayFrames > 0 && delayBuffer.size() >= delayFrames)
+        for (size_t i = 0; i < utils->channels; i++)
         {
-            const double value = delayBuffer.front() * feedbackValue;
+            delayBuffer->write(i, buffer[i]);
+        }
 
-            delayBuffer.pop();
-            delayBuffer.push(buffer[i] + value);
+        delayBuffer->advance();
 
-            buffer[i] += value * mixValue;
-        }
+        return;
+    }
 
-        else
-        {
-            delayBuffer.push(buffer[i]);
-        }
+    for (size_t i = 0; i < utils->channels; i++)
+    {
+        const double value = delayBuffer->read(delayFrames, i) * feedbackValue;
+
+        delayBuffer->write(i, buffer[i] + value);
+
+        buffer[i] += value * mixValue;
     }
+
+    delayBuffer->advance();
+}
+
+double Delay::getTail()
+{
+    return getFeedbackTail(delay->getValue(), feedback->getValue());
+}
+
+void Delay::updateInternal()
+{
+    mix->update();
+    delay->update();
+    feedback->update();
 }
 
 void Delay::init()
@@ -101,45 +263,95 @@ void Delay::init()
     feedback->start(startTime);
 }
 
+void Delay::serialize(Snapshot& snapshot)
+{
+    Effect::serialize(snapshot);
+
+    snapshot.object(mix);
+    snapshot.object(delay);
+    snapshot.object(feedback);
+
+    delayBuffer->serialize(snapshot);
+}
+
 Comb::Comb(ValueObject* mix, ValueObject* delay, ValueObject* feedback) :
-    mix(mix), delay(delay), feedback(feedback) {}
+    mix(mix), delay(delay), feedback(feedback)
+{
+    delayBuffer = new DelayBuffer(utils->sampleRate * getMaxDelay(delay) / 1000);
+
+    controls = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U) * 3);
+}
 
 Comb::~Comb()
 {
     delete mix;
     delete delay;
     delete feedback;
+
+    delete delayBuffer;
+
+    Arena::release(controls);
 }
 
 void Comb::apply(double* buffer)
 {
-    const size_t delayFrames = utils->channels * utils->sampleRate * delay->getValue() / 1000;
+    applyFrame(buffer, mix->getValue(), delay->getValue(), feedback->getValue());
+}
+
+void Comb::applyBlock(double* buffer, const size_t frames)
+{
+    const size_t length = std::max(utils->bufferLength, 1U);
+
+    mix->getBlock(controls, frames);
+    delay->getBlock(controls + length, frames);
+    feedback->getBlock(controls + length * 2, frames);
+
+    markUpdated(frames);
 
-    while (delayBuffer.size() > delayFrames)
+    for (size_t i = 0; i < frames; i++)
     {
-        delayBuffer.pop();
+        applyFrame(buffer + i * utils->channels, controls[i], controls[length + i], controls[length * 2 + i]);
     }
+}
 
-    const double mixValue = mix->getValue();
-    const double feedbackValue = feedback->getValue();
+void Comb::applyFrame(double* buffer, const double mixValue, const double delayValue, const double feedbackValue)
+{
+    const double delayFrames = utils->sampleRate * delayValue / 1000;
 
-    for (size_t i = 0; i < utils->channels; i++)
+    if (delayFrames < 1)
     {
-        if (delayFrames > 0 && delayBuffer.size() >= delayFrames)
+        for (size_t i = 0; i < utils->channels; i++)
         {
-            const double value = delayBuffer.front();
+            delayBuffer->write(i, buffer[i]);
+        }
 
-            delayBuffer.pop();
-            delayBuffer.push(buffer[i] - value * feedbackValue);
+        delayBuffer->advance();
 
-            buffer[i] = buffer[i] * (1 - mixValue) - value * feedbackValue * mixValue;
-        }
+        return;
+    }
 
-        else
-        {
-            delayBuffer.push(buffer[i]);
-        }
+    for (size_t i = 0; i < utils->channels; i++)
+    {
+        const double value = delayBuffer->read(delayFrames, i) * feedbackValue;
+
+        delayBuffer->write(i, buffer[i] - value);
+
+        buffer[i] = buffer[i] * (1 - mixValue) - value * mixValue;
     }
+
+    delayBuffer->advance();
+}
+
+double Comb::getTail()
+{
+    return getFeedbackTail(delay->getValue(), feedback->getValue());
+}
+
+void Comb::updateInternal()
+{
+    mix->update();
+    delay->update();
+    feedback->update();
 }
 
 void Comb::init()
@@ -149,43 +361,95 @@ void Comb::init()
     feedback->start(startTime);
 }
 
+void Comb::serialize(Snapshot& snapshot)
+{
+    Effect::serialize(snapshot);
+
+    snapshot.object(mix);
+    snapshot.object(delay);
+    snapshot.object(feedback);
+
+    delayBuffer->serialize(snapshot);
+}
+
 AllPass::AllPass(ValueObject* mix, ValueObject* delay, ValueObject* feedback) :
-    mix(mix), delay(delay), feedback(feedback) {}
+    mix(mix), delay(delay), feedback(feedback)
+{
+    delayBuffer = new DelayBuffer(utils->sampleRate * getMaxDelay(delay) / 1000);
+
+    controls = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U) * 3);
+}
 
 AllPass::~AllPass()
 {
     delete mix;
     delete delay;
     delete feedback;
+
+    delete delayBuffer;
+
+    Arena::release(controls);
 }
 
 void AllPass::apply(double* buffer)
 {
-    const size_t delayFrames = utils->channels * utils->sampleRate * delay->getValue() / 1000;
+    applyFrame(buffer, mix->getValue(), delay->getValue(), feedback->getValue());
+}
+
+void AllPass::applyBlock(double* buffer, const size_t frames)
+{
+    const size_t length = std::max(utils->bufferLength, 1U);
+
+    mix->getBlock(controls, frames);
+    delay->getBlock(controls + length, frames);
+    feedback->getBlock(controls + length * 2, frames);
 
-    while (delayBuffer.size() > delayFrames)
+    markUpdated(frames);
+
+    for (size_t i = 0; i < frames; i++)
     {
-        delayBuffer.pop();
+        applyFrame(buffer + i * utils->channels, controls[i], controls[length + i], controls[length * 2 + i]);
     }
+}
 
-    const double mixValue = mix->getValue();
-    const double feedbackValue = feedback->getValue();
+void AllPass::applyFrame(double* buffer, const double mixValue, const double delayValue, const double feedbackValue)
+{
+    const double delayFrames = utils->sampleRate * delayValue / 1000;
 
-    for (size_t i = 0; i < utils->channels; i++)
+    if (delayFrames < 1)
     {
-        double value = buffer[i] * feedbackValue;
-
-        if (delayFrames > 0 && delayBuffer.size() >= delayFrames)
+        for (size_t i = 0; i < utils->channels; i++)
         {
-            value += delayBuffer.front();
-
-            delayBuffer.pop();
+            delayBuffer->write(i, buffer[i]);
         }
 
-        delayBuffer.push(buffer[i] - value * feedbackValue);
+        delayBuffer->advance();
+
+        return;
+    }
+
+    for (size_t i = 0; i < utils->channels; i++)
+    {
+        const double value = buffer[i] * feedbackValue + delayBuffer->read(delayFrames, i);
+
+        delayBuffer->write(i, buffer[i] - value * feedbackValue);
 
         buffer[i] = buffer[i] * (1 - mixValue) + value * mixValue;
     }
+
+    delayBuffer->advance();
+}
+
+double AllPass::getTail()
+{
+    return getFeedbackTail(delay->getValue(), feedback->getValue());
+}
+
+void AllPass::updateInternal()
+{
+    mix->update();
+    delay->update();
+    feedback->update();
 }
 
 void AllPass::init()
@@ -195,192 +459,402 @@ void AllPass::init()
     feedback->start(startTime);
 }
 
+void AllPass::serialize(Snapshot& snapshot)
+{
+    Effect::serialize(snapshot);
+
+    snapshot.object(mix);
+    snapshot.object(delay);
+    snapshot.object(feedback);
+
+    delayBuffer->serialize(snapshot);
+}
+
 LowPass::LowPass(ValueObject* threshold) :
     threshold(threshold)
 {
-    raw = (double*)calloc(utils->channels * 2, sizeof(double));
-    filtered = (double*)calloc(utils->channels * 2, sizeof(double));
+    filter = new Biquad(utils->channels);
+
+    controls = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U));
 }
 
 LowPass::~LowPass()
 {
     delete threshold;
+    delete filter;
 
-    free(raw);
-    free(filtered);
+    Arena::release(controls);
 }
 
 void LowPass::apply(double* buffer)
 {
-    const double omega = tan(utils->pi * threshold->getValue() / utils->sampleRate);
-    const double omega2 = omega * omega;
-    const double c = 1 + sqrt(2) * omega + omega2;
-    const double a = omega2 / c;
-    const double b1 = 2 * (omega2 - 1) / c;
-    const double b2 = (1 - sqrt(2) * omega + omega2) / c;
-
-    for (size_t i = 0; i < utils->channels; i++)
-    {
-        const double value = buffer[i];
+    filter->setLowPass(threshold->getValue());
+    filter->apply(buffer);
+}
 
-        buffer[i] = a * (buffer[i] +  raw[i] * 2 + raw[i + utils->channels]) - b1 * filtered[i] - b2 * filtered[i + utils->channels];
+void LowPass::applyBlock(double* buffer, const size_t frames)
+{
+    threshold->getBlock(controls, frames);
 
-        raw[i + utils->channels] = raw[i];
-        raw[i] = value;
+    markUpdated(frames);
 
-        filtered[i + utils->channels] = filtered[i];
-        filtered[i] = buffer[i];
+    for (size_t i = 0; i < frames; i++)
+    {
+        filter->setLowPass(controls[i]);
+        filter->apply(buffer + i * utils->channels);
     }
 }
 
+void LowPass::updateInternal()
+{
+    threshold->update();
+}
+
 void LowPass::init()
 {
     threshold->start(startTime);
 }
 
-RingBuffer::RingBuffer(const size_t length) :
-    length(length)
+void LowPass::serialize(Snapshot& snapshot)
 {
-    buffer = (double*)calloc(length, sizeof(double));
+    Effect::serialize(snapshot);
+
+    snapshot.object(threshold);
+
+    filter->serialize(snapshot);
 }
 
-RingBuffer::~RingBuffer()
+Biquad::Biquad(const size_t lanes) :
+    lanes(lanes)
 {
-    free(buffer);
+    raw = (double*)calloc(lanes * 2, sizeof(double));
+    filtered = (double*)calloc(lanes * 2, sizeof(double));
 }
 
-void RingBuffer::push(const double value)
+Biquad::~Biquad()
 {
-    buffer[front++] = value;
+    free(raw);
+    free(filtered);
+}
 
-    if (front >= length)
+void Biquad::setLowPass(const double frequency)
+{
+    if (isCached(Low, frequency, M_SQRT1_2))
     {
-        front = 0;
+        return;
     }
+
+    const Utils* utils = Utils::get();
+
+    const double omega = tan(utils->pi * frequency / utils->sampleRate);
+    const double omega2 = omega * omega;
+    const double c = 1 + M_SQRT2 * omega + omega2;
+
+    a0 = omega2 / c;
+    a1 = a0 * 2;
+    a2 = a0;
+    b1 = 2 * (omega2 - 1) / c;
+    b2 = (1 - M_SQRT2 * omega + omega2) / c;
+
+    setCached(Low, frequency, M_SQRT1_2);
 }
 
-double RingBuffer::value() const
+void Biquad::setHighPass(const double frequency)
 {
-    return buffer[front];
+    if (isCached(High, frequency, M_SQRT1_2))
+    {
+        return;
+    }
+
+    const Utils* utils = Utils::get();
+
+    const double omega = tan(utils->pi * frequency / utils->sampleRate);
+    const double omega2 = omega * omega;
+    const double c = 1 + M_SQRT2 * omega + omega2;
+
+    a0 = 1 / c;
+    a1 = a0 * -2;
+    a2 = a0;
+    b1 = 2 * (omega2 - 1) / c;
+    b2 = (1 - M_SQRT2 * omega + omega2) / c;
+
+    setCached(High, frequency, M_SQRT1_2);
 }
 
-DelayLine::DelayLine(const size_t length)
+void Biquad::setBandPass(const double frequency, const double q)
 {
-    buffer = new RingBuffer(length);
+    if (isCached(Band, frequency, q))
+    {
+        return;
+    }
 
     const Utils* utils = Utils::get();
 
-    const double omega = tan(utils->pi * 5000 / utils->sampleRate);
+    const double omega = tan(utils->pi * frequency / utils->sampleRate);
     const double omega2 = omega * omega;
-    const double c = 1 + sqrt(2) * omega + omega2;
+    const double alpha = omega / q;
+    const double c = 1 + alpha + omega2;
 
-    c0 = omega2 / c;
-    c1 = 2 * (omega2 - 1) / c;
-    c2 = (1 - sqrt(2) * omega + omega2) / c;
+    a0 = alpha / c;
+    a1 = 0;
+    a2 = -a0;
+    b1 = 2 * (omega2 - 1) / c;
+    b2 = (1 - alpha + omega2) / c;
+
+    setCached(Band, frequency, q);
 }
 
-DelayLine::~DelayLine()
+void Biquad::setCached(const Response response, const double frequency, const double q)
 {
-    delete buffer;
+    this->response = response;
+
+    cutoff = frequency;
+    resonance = q;
 }
 
-void DelayLine::push(const double value)
+void Biquad::apply(double* values)
 {
-    buffer->push(value);
+    for (size_t i = 0; i < lanes; i++)
+    {
+        const double value = values[i];
+
+        values[i] = a0 * value + a1 * raw[i] + a2 * raw[i + lanes] - b1 * filtered[i] - b2 * filtered[i + lanes];
+
+        raw[i + lanes] = raw[i];
+        raw[i] = value;
+
+        filtered[i + lanes] = filtered[i];
+        filtered[i] = values[i];
+    }
 }
 
-double DelayLine::value()
+void Biquad::serialize(Snapshot& snapshot)
 {
-    const double input = buffer->value();
-    const double output = c0 * (input + raw[0] * 2 + raw[1]) - c1 * filtered[0] - c2 * filtered[1];
+    snapshot.bytes(raw, sizeof(double) * lanes * 2);
+    snapshot.bytes(filtered, sizeof(double) * lanes * 2);
+}
 
-    raw[1] = raw[0];
-    raw[0] = input;
+DelayBuffer::DelayBuffer(const double frames) :
+    limit(std::max(frames, 0.0))
+{
+    // allocated once when the graph is built so that rendering never
+    // allocates, the capacity is a power of two so positions wrap with a mask
+
+    channels = Utils::get()->channels;
+    capacity = 1;
+
+    while (capacity < limit + 1)
+    {
+        capacity *= 2;
+    }
+
+    mask = capacity - 1;
+
+    // reads reach at most limit + 1 frames back for interpolation, older
+    // frames are overwritten before they can be read again
 
-    filtered[1] = filtered[0];
-    filtered[0] = output;
+    span = std::min(capacity, (size_t)limit + 2);
 
-    return output;
+    buffer = (double*)calloc(capacity * channels, sizeof(double));
+
+    if (!buffer)
+    {
+        throw std::bad_alloc();
+    }
 }
 
-DelayMatrix::DelayMatrix()
+DelayBuffer::~DelayBuffer()
 {
-    utils = Utils::get();
+    free(buffer);
+}
 
-    lines = (DelayLine**)malloc(sizeof(DelayLine*) * 16 * utils->channels);
+double DelayBuffer::read(const double delay, const size_t channel) const
+{
+    // delays past the limit the buffer was sized for read the oldest frame
+    // held for it
 
-    std::uniform_int_distribution<size_t> udist(0, 1000);
+    const double clamped = std::min(delay, limit);
 
-    for (size_t i = 0; i < 16; i++)
+    const size_t frames = clamped;
+    const double fraction = clamped - frames;
+    const double value = buffer[((position - frames) & mask) * channels + channel];
+
+    if (fraction == 0)
     {
-        const size_t length = 2000U + i * 1000U + udist(utils->rng);
+        return value;
+    }
 
-        for (size_t j = 0; j < utils->channels; j++)
-        {
-            lines[i * utils->channels + j] = new DelayLine(length);
-        }
+    return value + (buffer[((position - frames - 1) & mask) * channels + channel] - value) * fraction;
+}
 
-        if (i == 15)
-        {
-            delayLength = length * 1000 / utils->sampleRate;
-        }
+void DelayBuffer::write(const size_t channel, const double value)
+{
+    buffer[(position & mask) * channels + channel] = value;
+}
+
+void DelayBuffer::advance()
+{
+    position++;
+}
+
+void DelayBuffer::serialize(Snapshot& snapshot)
+{
+    // only the frames a read can still reach are stored, oldest first, the
+    // rest of the buffer is cleared on restore
+
+    size_t length = span;
+
+    snapshot.value(length);
+
+    if (length != span)
+    {
+        throw OrganicFileException("Could not restore state, the snapshot does not match the program.");
+    }
+
+    snapshot.value(position);
+
+    if (snapshot.isRestoring())
+    {
+        memset(buffer, 0, sizeof(double) * capacity * channels);
     }
 
-    values = (double*)malloc(sizeof(double) * 16);
+    const size_t frames = std::min(position + 1, span);
+    const size_t start = (position - frames + 1) & mask;
+    const size_t first = std::min(frames, capacity - start);
+
+    snapshot.bytes(buffer + start * channels, sizeof(double) * first * channels);
+    snapshot.bytes(buffer, sizeof(double) * (frames - first) * channels);
 }
 
-DelayMatrix::~DelayMatrix()
+DelayMatrix::DelayMatrix()
 {
-    for (size_t i = 0; i < 16 * utils->channels; i++)
+    utils = Utils::get();
+
+    RandomStream random;
+
+    size_t total = 0;
+
+    for (size_t i = 0; i < 16; i++)
     {
-        delete lines[i];
+        lengths[i] = 2000U + i * 1000U + random.index(1000);
+        offsets[i] = total * utils->channels;
+
+        total += lengths[i];
     }
 
+    delayLength = lengths[15] * 1000 / utils->sampleRate;
+
+    lines = (double*)calloc(total * utils->channels, sizeof(double));
+    inputs = (double*)calloc(16 * utils->channels, sizeof(double));
+
+    damping = new Biquad(16 * utils->channels);
+    damping->setLowPass(5000);
+}
+
+DelayMatrix::~DelayMatrix()
+{
     free(lines);
-    free(values);
+    free(inputs);
+
+    delete damping;
 }
 
 void DelayMatrix::apply(double* buffer, const double lengthValue, const double mixValue)
 {
-    const double feedbackValue = exp(-3 * delayLength / lengthValue);
+    if (lengthValue != feedbackLength)
+    {
+        feedbackLength = lengthValue;
+        feedbackValue = exp(-3 * delayLength / lengthValue);
+    }
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        memcpy(inputs + i * utils->channels, lines + offsets[i] + positions[i] * utils->channels, sizeof(double) * utils->channels);
+    }
+
+    damping->apply(inputs);
 
     for (size_t i = 0; i < utils->channels; i++)
     {
         for (size_t j = 0; j < 16; j++)
         {
-            values[j] = lines[j * utils->channels + i]->value();
+            values[j] = inputs[j * utils->channels + i];
         }
 
+        transform(values);
+
         double sum = 0;
 
         for (size_t j = 0; j < 16; j++)
         {
-            double mult = 0;
+            const double value = values[j] * feedbackValue;
 
-            for (size_t k = 0; k < 16; k++)
-            {
-                mult += values[k] * coeffs[j * 16 + k] * 0.25;
-            }
+            lines[offsets[j] + positions[j] * utils->channels + i] = buffer[i] + value;
+
+            sum += value;
+        }
 
-            mult *= feedbackValue;
+        buffer[i] = buffer[i] * (1 - mixValue) + sum * mixValue / 16;
+    }
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        if (++positions[i] >= lengths[i])
+        {
+            positions[i] = 0;
+        }
+    }
+}
 
-            lines[j * utils->channels + i]->push(buffer[i] + mult);
+void DelayMatrix::transform(double* values)
+{
+    for (size_t i = 0; i < 16; i += 4)
+    {
+        const double sum = (values[i] + values[i + 1] + values[i + 2] + values[i + 3]) / 2;
 
-            sum += mult;
+        for (size_t j = i; j < i + 4; j++)
+        {
+            values[j] -= sum;
         }
+    }
 
-        buffer[i] = buffer[i] * (1 - mixValue) + sum * mixValue / 16;
+    for (size_t i = 0; i < 4; i++)
+    {
+        const double sum = (values[i] + values[i + 4] + values[i + 8] + values[i + 12]) / 2;
+
+        for (size_t j = i; j < 16; j += 4)
+        {
+            values[j] -= sum;
+        }
     }
 }
 
+void DelayMatrix::serialize(Snapshot& snapshot)
+{
+    snapshot.bytes(lines, sizeof(double) * (offsets[15] + lengths[15] * utils->channels));
+    snapshot.value(positions);
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        snapshot.expect(positions[i] < lengths[i]);
+    }
+
+    damping->serialize(snapshot);
+}
+
 Reverb::Reverb(ValueObject* mix, ValueObject* length) :
-    mix(mix), length(length) {}
+    mix(mix), length(length)
+{
+    controls = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U) * 2);
+}
 
 Reverb::~Reverb()
 {
     delete mix;
     delete length;
     delete matrix;
+
+    Arena::release(controls);
 }
 
 void Reverb::apply(double* buffer)
@@ -388,8 +862,244 @@ void Reverb::apply(double* buffer)
     matrix->apply(buffer, length->getValue(), mix->getValue());
 }
 
+void Reverb::applyBlock(double* buffer, const size_t frames)
+{
+    const size_t blockLength = std::max(utils->bufferLength, 1U);
+
+    mix->getBlock(controls, frames);
+    length->getBlock(controls + blockLength, frames);
+
+    markUpdated(frames);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        matrix->apply(buffer + i * utils->channels, controls[blockLength + i], controls[i]);
+    }
+}
+
+double Reverb::getTail()
+{
+    return length->getValue();
+}
+
+void Reverb::updateInternal()
+{
+    mix->update();
+    length->update();
+}
+
 void Reverb::init()
 {
     mix->start(startTime);
     length->start(startTime);
 }
+
+void Reverb::serialize(Snapshot& snapshot)
+{
+    Effect::serialize(snapshot);
+
+    snapshot.object(mix);
+    snapshot.object(length);
+
+    matrix->serialize(snapshot);
+}
+
+Convolve::Convolve(ValueObject* mix, Resource* impulse) :
+    mix(mix), impulse(impulse)
+{
+    const size_t size = partitionLength * 2;
+    const size_t frames = impulse->frames;
+
+    fft = new FFT(size);
+
+    // the first partition is applied directly so the wet signal has no
+    // latency, the partitions after it go through the frequency domain one
+    // partition late, which is exactly where they belong
+
+    const size_t tail = frames > partitionLength ? frames - partitionLength : 0;
+
+    partitions = std::max<size_t>((tail + partitionLength - 1) / partitionLength, 1);
+
+    filters = (std::complex<double>*)calloc(utils->channels * partitions * size, sizeof(std::complex<double>));
+    spectra = (std::complex<double>*)calloc(utils->channels * partitions * size, sizeof(std::complex<double>));
+    block = (std::complex<double>*)calloc(size, sizeof(std::complex<double>));
+
+    head = (double*)calloc(utils->channels * partitionLength, sizeof(double));
+    input = (double*)calloc(utils->channels * size, sizeof(double));
+    output = (double*)calloc(utils->channels * partitionLength, sizeof(double));
+
+    controls = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U));
+
+    for (size_t i = 0; i < utils->channels; i++)
+    {
+        const float* samples = impulse->getChannel(i);
+
+        // stored reversed to line up with the input history
+
+        for (size_t j = 0; j < partitionLength && j < frames; j++)
+        {
+            head[(i + 1) * partitionLength - 1 - j] = samples[j];
+        }
+
+        for (size_t j = 0; j < partitions; j++)
+        {
+            std::complex<double>* filter = filters + (i * partitions + j) * size;
+
+            for (size_t k = 0; k < partitionLength && (j + 1) * partitionLength + k < frames; k++)
+            {
+                filter[k] = samples[(j + 1) * partitionLength + k];
+            }
+
+            fft->forward(filter);
+        }
+    }
+}
+
+Convolve::~Convolve()
+{
+    delete mix;
+    delete impulse;
+    delete fft;
+
+    free(filters);
+    free(spectra);
+    free(block);
+    free(head);
+    free(input);
+    free(output);
+
+    Arena::release(controls);
+}
+
+void Convolve::apply(double* buffer)
+{
+    applyFrame(buffer, mix->getValue());
+}
+
+void Convolve::applyBlock(double* buffer, const size_t frames)
+{
+    mix->getBlock(controls, frames);
+
+    markUpdated(frames);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        applyFrame(buffer + i * utils->channels, controls[i]);
+    }
+}
+
+void Convolve::applyFrame(double* buffer, const double mixValue)
+{
+    for (size_t i = 0; i < utils->channels; i++)
+    {
+        double* history = input + i * partitionLength * 2;
+
+        history[partitionLength + position] = buffer[i];
+
+        // the last partitionLength inputs end at the current one, four
+        // running sums keep the dot product vectorizable
+
+        const double* taps = head + i * partitionLength;
+        const double* samples = history + position + 1;
+
+        double sums[4] = { 0 };
+
+        for (size_t j = 0; j < partitionLength; j += 4)
+        {
+            for (size_t k = 0; k < 4; k++)
+            {
+                sums[k] += taps[j + k] * samples[j + k];
+            }
+        }
+
+        const double wet = output[i * partitionLength + position] + (sums[0] + sums[1]) + (sums[2] + sums[3]);
+
+        buffer[i] = buffer[i] * (1 - mixValue) + wet * mixValue;
+    }
+
+    if (++position == partitionLength)
+    {
+        process();
+
+        position = 0;
+    }
+}
+
+void Convolve::process()
+{
+    const size_t size = partitionLength * 2;
+
+    current = (current + partitions - 1) % partitions;
+
+    for (size_t i = 0; i < utils->channels; i++)
+    {
+        double* history = input + i * size;
+
+        std::complex<double>* spectrum = spectra + (i * partitions + current) * size;
+
+        for (size_t j = 0; j < size; j++)
+        {
+            spectrum[j] = history[j];
+        }
+
+        fft->forward(spectrum);
+
+        memset((void*)block, 0, sizeof(std::complex<double>) * size);
+
+        for (size_t j = 0; j < partitions; j++)
+        {
+            const std::complex<double>* filter = filters + (i * partitions + j) * size;
+            const std::complex<double>* delayed = spectra + (i * partitions + (current + j) % partitions) * size;
+
+            for (size_t k = 0; k <= partitionLength; k++)
+            {
+                block[k] += std::complex<double>(filter[k].real() * delayed[k].real() - filter[k].imag() * delayed[k].imag(), filter[k].real() * delayed[k].imag() + filter[k].imag() * delayed[k].real());
+            }
+        }
+
+        for (size_t j = 1; j < partitionLength; j++)
+        {
+            block[size - j] = std::conj(block[j]);
+        }
+
+        fft->inverse(block);
+
+        for (size_t j = 0; j < partitionLength; j++)
+        {
+            output[i * partitionLength + j] = block[partitionLength + j].real();
+        }
+
+        memmove(history, history + partitionLength, sizeof(double) * partitionLength);
+    }
+}
+
+double Convolve::getTail()
+{
+    return (double)(partitions + 1) * partitionLength * 1000 / utils->sampleRate;
+}
+
+void Convolve::updateInternal()
+{
+    mix->update();
+}
+
+void Convolve::init()
+{
+    mix->start(startTime);
+}
+
+void Convolve::serialize(Snapshot& snapshot)
+{
+    Effect::serialize(snapshot);
+
+    snapshot.object(mix);
+
+    snapshot.bytes(spectra, sizeof(std::complex<double>) * utils->channels * partitions * partitionLength * 2);
+    snapshot.bytes(input, sizeof(double) * utils->channels * partitionLength * 2);
+    snapshot.bytes(output, sizeof(double) * utils->channels * partitionLength);
+
+    snapshot.value(position);
+    snapshot.value(current);
+
+    snapshot.expect(position < partitionLength && current < partitions);
+}
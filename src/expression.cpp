@@ -0,0 +1,233 @@
+#include "../include/expression.h"
+
+using namespace Engine;
+
+Expression::Expression(const std::vector<Instruction>& instructions, const std::vector<ValueObject*>& inputs, const std::vector<double>& constants, const size_t output) :
+    instructions(instructions), inputs(inputs), output(output)
+{
+    registers = (double*)malloc(sizeof(double) * constants.size());
+
+    for (size_t i = 0; i < constants.size(); i++)
+    {
+        registers[i] = constants[i];
+    }
+}
+
+Expression::~Expression()
+{
+    for (const ValueObject* input : inputs)
+    {
+        delete input;
+    }
+
+    free(registers);
+}
+
+double Expression::getValue() const
+{
+    if (!enabled)
+    {
+        return 0;
+    }
+
+    for (const Instruction& instruction : instructions)
+    {
+        switch (instruction.opcode)
+        {
+            case Opcode::Load:
+                registers[instruction.output] = inputs[instruction.input1]->getValue();
+
+                break;
+
+            case Opcode::Negate:
+                registers[instruction.output] = -registers[instruction.input1];
+
+                break;
+
+            default:
+                registers[instruction.output] = evaluate(instruction.opcode, registers[instruction.input1], registers[instruction.input2]);
+
+                break;
+        }
+    }
+
+    return registers[output];
+}
+
+double Expression::evaluate(const Opcode& opcode, const double value1, const double value2)
+{
+    switch (opcode)
+    {
+        case Opcode::Negate:
+            return -value1;
+
+        case Opcode::Add:
+            return value1 + value2;
+
+        case Opcode::Subtract:
+            return value1 - value2;
+
+        case Opcode::Multiply:
+            return value1 * value2;
+
+        case Opcode::Divide:
+            return value1 / value2;
+
+        case Opcode::Power:
+            return pow(value1, value2);
+
+        case Opcode::Equals:
+            return value1 == value2;
+
+        case Opcode::Less:
+            return value1 < value2;
+
+        case Opcode::Greater:
+            return value1 > value2;
+
+        case Opcode::LessEqual:
+            return value1 <= value2;
+
+        case Opcode::GreaterEqual:
+            return value1 >= value2;
+
+        default:
+            return value1;
+    }
+}
+
+bool Expression::isLeftIdentity(const Opcode& opcode, const double value)
+{
+    return (opcode == Opcode::Add && value == 0) || (opcode == Opcode::Multiply && value == 1);
+}
+
+bool Expression::isRightIdentity(const Opcode& opcode, const double value)
+{
+    switch (opcode)
+    {
+        case Opcode::Add:
+        case Opcode::Subtract:
+            return value == 0;
+
+        case Opcode::Multiply:
+        case Opcode::Divide:
+        case Opcode::Power:
+            return value == 1;
+
+        default:
+            return false;
+    }
+}
+
+void Expression::updateInternal()
+{
+    for (ValueObject* input : inputs)
+    {
+        input->update();
+    }
+
+    for (const ValueObject* input : inputs)
+    {
+        if (!input->enabled)
+        {
+            stop(input->getStopTime());
+
+            return;
+        }
+    }
+}
+
+void Expression::init()
+{
+    for (ValueObject* input : inputs)
+    {
+        input->start(startTime);
+    }
+}
+
+size_t ExpressionBuilder::constant(const double value)
+{
+    return allocate(value, true);
+}
+
+size_t ExpressionBuilder::load(ValueObject* input)
+{
+    const size_t output = allocate(0, false);
+
+    instructions.push_back({ Opcode::Load, output, inputs.size(), output });
+    inputs.push_back(input);
+
+    return output;
+}
+
+size_t ExpressionBuilder::unary(const Opcode& opcode, const size_t input)
+{
+    if (known[input])
+    {
+        return constant(Expression::evaluate(opcode, constants[input], 0));
+    }
+
+    const size_t output = allocate(0, false);
+
+    instructions.push_back({ opcode, output, input, input });
+
+    return output;
+}
+
+size_t ExpressionBuilder::binary(const Opcode& opcode, const size_t input1, const size_t input2)
+{
+    if (known[input1] && known[input2])
+    {
+        return constant(Expression::evaluate(opcode, constants[input1], constants[input2]));
+    }
+
+    if (known[input1] && Expression::isLeftIdentity(opcode, constants[input1]))
+    {
+        return input2;
+    }
+
+    if (known[input2] && Expression::isRightIdentity(opcode, constants[input2]))
+    {
+        return input1;
+    }
+
+    if (opcode == Opcode::Power && known[input2] && constants[input2] == 2)
+    {
+        return binary(Opcode::Multiply, input1, input1);
+    }
+
+    const size_t output = allocate(0, false);
+
+    instructions.push_back({ opcode, output, input1, input2 });
+
+    return output;
+}
+
+void Expression::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    for (ValueObject* input : inputs)
+    {
+        snapshot.object(input);
+    }
+}
+
+ValueObject* ExpressionBuilder::build(const size_t output) const
+{
+    if (known[output] && inputs.empty())
+    {
+        return new Value(constants[output]);
+    }
+
+    return new Expression(instructions, inputs, constants, output);
+}
+
+size_t ExpressionBuilder::allocate(const double value, const bool known)
+{
+    constants.push_back(value);
+
+    this->known.push_back(known);
+
+    return constants.size() - 1;
+}
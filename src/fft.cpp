@@ -0,0 +1,82 @@
+#include "../include/fft.h"
+
+using namespace Engine;
+
+FFT::FFT(const size_t size) :
+    size(size), reversed(size), twiddles(size / 2)
+{
+    size_t bits = 0;
+
+    while (((size_t)1 << bits) < size)
+    {
+        bits++;
+    }
+
+    for (size_t i = 0; i < size; i++)
+    {
+        size_t value = 0;
+
+        for (size_t j = 0; j < bits; j++)
+        {
+            value |= ((i >> j) & 1) << (bits - 1 - j);
+        }
+
+        reversed[i] = value;
+    }
+
+    for (size_t i = 0; i < size / 2; i++)
+    {
+        twiddles[i] = std::polar(1.0, -2 * M_PI * i / size);
+    }
+}
+
+void FFT::forward(std::complex<double>* values) const
+{
+    transform(values);
+}
+
+void FFT::inverse(std::complex<double>* values) const
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        values[i] = std::conj(values[i]);
+    }
+
+    transform(values);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        values[i] = std::conj(values[i]) / (double)size;
+    }
+}
+
+void FFT::transform(std::complex<double>* values) const
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (i < reversed[i])
+        {
+            std::swap(values[i], values[reversed[i]]);
+        }
+    }
+
+    for (size_t length = 2; length <= size; length *= 2)
+    {
+        const size_t half = length / 2;
+        const size_t stride = size / length;
+
+        for (size_t i = 0; i < size; i += length)
+        {
+            for (size_t j = 0; j < half; j++)
+            {
+                const std::complex<double>& x = values[i + j + half];
+                const std::complex<double>& w = twiddles[j * stride];
+
+                const std::complex<double> value(x.real() * w.real() - x.imag() * w.imag(), x.real() * w.imag() + x.imag() * w.real());
+
+                values[i + j + half] = values[i + j] - value;
+                values[i + j] += value;
+            }
+        }
+    }
+}
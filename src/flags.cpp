@@ -89,6 +89,45 @@ ProgramOptions FlagParser::getOptions()
             options.exportPath.emplace(path);
         }
 
+        else if (flag == "--load-state")
+        {
+            if (options.loadState)
+            {
+                throw OrganicArgumentException("The option \"--load-state\" was already set.");
+            }
+
+            const Path path = Path::relative(Path::formatPath(nextOption(flag)));
+
+            if (!path.isFile())
+            {
+                throw OrganicArgumentException("The specified state file does not exist.");
+            }
+
+            options.loadState.emplace(path);
+        }
+
+        else if (flag == "--save-state")
+        {
+            if (options.saveState)
+            {
+                throw OrganicArgumentException("The option \"--save-state\" was already set.");
+            }
+
+            const Path path = Path::relative(Path::formatPath(nextOption(flag)));
+
+            if (!path.parent().exists())
+            {
+                throw OrganicArgumentException("The specified state file is in a non-existent directory.");
+            }
+
+            if (path.isDirectory())
+            {
+                throw OrganicArgumentException("The specified state path is a directory, it must be a file.");
+            }
+
+            options.saveState.emplace(path);
+        }
+
         else if (flag == "--mono")
         {
             if (options.channels)
@@ -119,6 +158,26 @@ ProgramOptions FlagParser::getOptions()
             options.bufferLength = nextInt(flag);
         }
 
+        else if (flag == "--lookahead")
+        {
+            if (options.lookahead)
+            {
+                throw OrganicArgumentException("The option \"--lookahead\" was already set.");
+            }
+
+            options.lookahead = nextInt(flag);
+        }
+
+        else if (flag == "--threads")
+        {
+            if (options.threads)
+            {
+                throw OrganicArgumentException("The option \"--threads\" was already set.");
+            }
+
+            options.threads = nextInt(flag);
+        }
+
         else if (flag == "--seed")
         {
             if (options.seed)
@@ -129,6 +188,43 @@ ProgramOptions FlagParser::getOptions()
             options.seed = nextLong(flag);
         }
 
+        else if (flag == "--bytecode")
+        {
+            if (options.bytecode)
+            {
+                throw OrganicArgumentException("The option \"--bytecode\" was already set.");
+            }
+
+            options.bytecode = true;
+        }
+
+        else if (flag == "--control-period")
+        {
+            if (options.controlPeriod)
+            {
+                throw OrganicArgumentException("The option \"--control-period\" was already set.");
+            }
+
+            options.controlPeriod = nextInt(flag);
+        }
+
+        else if (flag == "--cache")
+        {
+            if (options.cache)
+            {
+                throw OrganicArgumentException("The option \"--cache\" was already set.");
+            }
+
+            const Path path = Path::relative(Path::formatPath(nextOption(flag)));
+
+            if (!path.isDirectory())
+            {
+                throw OrganicArgumentException("The specified cache directory does not exist.");
+            }
+
+            options.cache.emplace(path);
+        }
+
         else
         {
             throw OrganicArgumentException("Unknown option \"" + flag + "\".");
@@ -145,11 +241,21 @@ ProgramOptions FlagParser::getOptions()
         throw OrganicArgumentException("Cannot fast forward when exporting.");
     }
 
+    if (options.saveState && !options.time)
+    {
+        throw OrganicArgumentException("Cannot save state without a time limit.");
+    }
+
     if (options.exportPath && options.bufferLength)
     {
         throw OrganicArgumentException("Cannot set buffer length when exporting.");
     }
 
+    if (options.exportPath && options.lookahead)
+    {
+        throw OrganicArgumentException("Cannot set lookahead when exporting.");
+    }
+
     return options;
 }
 
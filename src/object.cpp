@@ -2,8 +2,24 @@
 
 using namespace Engine;
 
+thread_local std::unordered_set<Sync*>* Sync::created = nullptr;
+
 Sync::Sync() :
-    utils(Utils::get()) {}
+    utils(Utils::get())
+{
+    if (created)
+    {
+        created->insert(this);
+    }
+}
+
+Sync::~Sync()
+{
+    if (created)
+    {
+        created->erase(this);
+    }
+}
 
 void Sync::start(double time)
 {
@@ -14,6 +30,11 @@ void Sync::start(double time)
 
         enabled = true;
 
+        if (utils->seeking)
+        {
+            utils->transitions++;
+        }
+
         init();
     }
 }
@@ -22,6 +43,11 @@ void Sync::repeat(double time)
 {
     repeatTime = time;
 
+    if (utils->seeking)
+    {
+        utils->transitions++;
+    }
+
     reinit();
 }
 
@@ -31,9 +57,27 @@ void Sync::stop(const double time)
     {
         stopTime = time;
         enabled = false;
+
+        if (utils->seeking)
+        {
+            utils->transitions++;
+        }
     }
 }
 
+void Sync::bind(Utils* utils)
+{
+    this->utils = utils;
+}
+
+void Sync::serialize(Snapshot& snapshot)
+{
+    snapshot.value(enabled);
+    snapshot.value(startTime);
+    snapshot.value(repeatTime);
+    snapshot.value(stopTime);
+}
+
 void Sync::init() {}
 void Sync::reinit() {}
 
@@ -43,6 +87,8 @@ void Defaults::deinit()
     {
         delete pair.second;
     }
+
+    objects.clear();
 }
 
 ValueObject::~ValueObject() {}
@@ -52,6 +98,81 @@ double ValueObject::getValue() const
     return 0;
 }
 
+size_t ValueObject::getBlock(double* values, const size_t frames)
+{
+    const size_t start = utils->frame;
+
+    size_t active = frames;
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        if (i > 0)
+        {
+            utils->setFrame(start + i);
+        }
+
+        update();
+
+        values[i] = getValue();
+
+        if (!enabled && active == frames)
+        {
+            active = i;
+        }
+    }
+
+    if (frames > 1)
+    {
+        utils->setFrame(start);
+    }
+
+    return active;
+}
+
+void ValueObject::updateBlock(const size_t frames)
+{
+    const size_t start = utils->frame;
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        if (i > 0)
+        {
+            utils->setFrame(start + i);
+        }
+
+        update();
+    }
+
+    if (frames > 1)
+    {
+        utils->setFrame(start);
+    }
+}
+
+Constants::Rate ValueObject::getRate() const
+{
+    return Constants::Audio;
+}
+
+double ValueObject::getMaximum() const
+{
+    // the largest value an object can reach, used to size buffers before
+    // rendering, anything that cannot be bounded from its structure is
+    // unbounded
+
+    return std::numeric_limits<double>::infinity();
+}
+
+void* ValueObject::operator new(const size_t size)
+{
+    return Arena::acquire(size);
+}
+
+void ValueObject::operator delete(void* pointer)
+{
+    Arena::release(pointer);
+}
+
 ValueObject* ValueObject::getLeaf()
 {
     if (!enabled)
@@ -62,7 +183,52 @@ ValueObject* ValueObject::getLeaf()
     return this;
 }
 
-void ValueObject::update() {}
+void ValueObject::serialize(Snapshot& snapshot)
+{
+    Sync::serialize(snapshot);
+
+    snapshot.value(updateFrame);
+}
+
+void ValueObject::updateInternal() {}
+
+size_t ValueObject::finishBlock(ValueObject* value, double* values, const size_t active, const size_t frames)
+{
+    // the frame a block stopped at is recorded, so a node read again within
+    // that block keeps the frames before it, only a node that stopped before
+    // the block starts reads as stopped throughout
+
+    const size_t start = utils->frame;
+
+    size_t length = 0;
+
+    if (enabled)
+    {
+        length = active;
+
+        if (active < frames)
+        {
+            blockStop = start + active;
+            blockGeneration = utils->generation;
+        }
+    }
+
+    else if (blockGeneration == utils->generation && blockStop > start)
+    {
+        length = std::min(active, blockStop - start);
+    }
+
+    markUpdated(frames);
+
+    if (active < frames)
+    {
+        stop(value->getStopTime());
+    }
+
+    memset(values + length, 0, sizeof(double) * (frames - length));
+
+    return length;
+}
 
 List::List(const std::vector<ValueObject*>& objects) :
     objects(objects) {}
@@ -75,6 +241,16 @@ List::~List()
     }
 }
 
+void List::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    for (ValueObject* object : objects)
+    {
+        snapshot.object(object);
+    }
+}
+
 Variable::Variable(ValueObject* value) :
     value(value) {}
 
@@ -88,6 +264,21 @@ double Variable::getValue() const
     return value->getValue();
 }
 
+size_t Variable::getBlock(double* values, const size_t frames)
+{
+    return finishBlock(value, values, value->getBlock(values, frames), frames);
+}
+
+Constants::Rate Variable::getRate() const
+{
+    return value ? value->getRate() : Constants::Audio;
+}
+
+double Variable::getMaximum() const
+{
+    return value ? value->getMaximum() : std::numeric_limits<double>::infinity();
+}
+
 ValueObject* Variable::getLeaf()
 {
     if (!enabled)
@@ -98,7 +289,7 @@ ValueObject* Variable::getLeaf()
     return value->getLeaf();
 }
 
-void Variable::update()
+void Variable::updateInternal()
 {
     value->update();
 
@@ -113,6 +304,148 @@ void Variable::init()
     value->start(startTime);
 }
 
+void Variable::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(value);
+}
+
+SharedValue::SharedValue(ValueObject* value) :
+    value(value)
+{
+    history = (double*)Arena::acquire(sizeof(double) * std::max(utils->bufferLength, 1U));
+}
+
+SharedValue::~SharedValue()
+{
+    Arena::release(history);
+
+    delete value;
+}
+
+double SharedValue::getValue() const
+{
+    if (!enabled)
+    {
+        return 0;
+    }
+
+    if (holds(utils->frame))
+    {
+        return history[utils->frame - historyStart];
+    }
+
+    return value->getValue();
+}
+
+size_t SharedValue::getBlock(double* values, const size_t frames)
+{
+    const size_t start = utils->frame;
+
+    size_t active = frames;
+
+    for (size_t offset = 0; offset < frames;)
+    {
+        if (offset > 0)
+        {
+            utils->setFrame(start + offset);
+        }
+
+        if (!holds(start + offset))
+        {
+            evaluate(std::min<size_t>(frames - offset, std::max(utils->bufferLength, 1U)));
+        }
+
+        const size_t length = std::min(frames - offset, historyStart + historyLength - start - offset);
+
+        memcpy(values + offset, history + start + offset - historyStart, sizeof(double) * length);
+
+        if (active == frames && historyStop < start + offset + length)
+        {
+            active = std::max(historyStop, start + offset) - start;
+        }
+
+        offset += length;
+    }
+
+    if (utils->frame != start)
+    {
+        utils->setFrame(start);
+    }
+
+    return finishBlock(value, values, active, frames);
+}
+
+Constants::Rate SharedValue::getRate() const
+{
+    return value->getRate();
+}
+
+double SharedValue::getMaximum() const
+{
+    return value->getMaximum();
+}
+
+ValueObject* SharedValue::getLeaf()
+{
+    if (!enabled)
+    {
+        return nullptr;
+    }
+
+    return value->getLeaf();
+}
+
+void SharedValue::updateInternal()
+{
+    if (!holds(utils->frame))
+    {
+        evaluate(1);
+    }
+
+    if (historyStop <= utils->frame)
+    {
+        stop(value->getStopTime());
+    }
+}
+
+void SharedValue::init()
+{
+    historyGeneration = -1;
+
+    value->start(startTime);
+}
+
+void SharedValue::evaluate(const size_t frames)
+{
+    const size_t frame = utils->frame;
+
+    if (historyGeneration != utils->generation || frame != historyStart + historyLength || historyLength + frames > std::max(utils->bufferLength, 1U))
+    {
+        historyStart = frame;
+        historyLength = 0;
+        historyStop = -1;
+        historyGeneration = utils->generation;
+    }
+
+    const size_t active = value->getBlock(history + historyLength, frames);
+
+    if (active < frames && historyStop == (size_t)-1)
+    {
+        historyStop = frame + active;
+    }
+
+    historyLength += frames;
+}
+
+void SharedValue::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    snapshot.object(value);
+}
+
 Lambda::Lambda(const std::vector<Variable*>& inputs, ValueObject* value) :
     inputs(inputs), value(value) {}
 
@@ -139,7 +472,7 @@ double Lambda::getValue() const
     return value->getValue();
 }
 
-void Lambda::update()
+void Lambda::updateInternal()
 {
     value->update();
 
@@ -166,3 +499,15 @@ void Lambda::init()
 
     value->start(startTime);
 }
+
+void Lambda::serialize(Snapshot& snapshot)
+{
+    ValueObject::serialize(snapshot);
+
+    for (Variable* input : inputs)
+    {
+        snapshot.object(input);
+    }
+
+    snapshot.object(value);
+}
@@ -3,11 +3,14 @@
 Organic::Organic(const Path& path, const ProgramOptions& options) :
     options(options)
 {
-    utils = Utils::get();
+    utils = new Utils();
+
+    Utils::set(utils);
 
     utils->channels = options.channels.value_or(2);
     utils->sampleRate = options.sampleRate.value_or(44100);
     utils->bufferLength = options.bufferLength.value_or(128);
+    utils->threads = options.threads.value_or(1);
     utils->timeStep = 1000.0 / utils->sampleRate;
 
     utils->setSeed(options.seed);
@@ -28,10 +31,15 @@ Organic::Organic(const Path& path, const ProgramOptions& options) :
 
     program->resolveTypes();
 
-    TokenTransformer* transformer = new TokenTransformer(path);
+    TokenTransformer* transformer = new TokenTransformer(path, options.bytecode.value_or(false), options.controlPeriod.value_or(1), options.cache);
 
     this->program = program->transform(transformer);
 
+    if (options.info.value_or(false))
+    {
+        std::cout << "Program Memory: " << this->program->getMemoryUsage() << " bytes\n";
+    }
+
     delete transformer;
     delete program;
     delete source;
@@ -39,10 +47,14 @@ Organic::Organic(const Path& path, const ProgramOptions& options) :
 
 Organic::~Organic()
 {
+    delete queue;
     delete program;
-    delete utils;
 
     Engine::Defaults::deinit();
+
+    Utils::set(nullptr);
+
+    delete utils;
 }
 
 void Organic::start()
@@ -81,21 +93,23 @@ void Organic::startPlayback()
 
     program->start(0);
 
+    if (options.loadState)
+    {
+        loadState();
+    }
+
     if (options.fastForward)
     {
-        const size_t frames = utils->sampleRate * options.fastForward.value() / 1000;
+        program->seek(utils->sampleRate * options.fastForward.value() / 1000);
+    }
 
-        double* buffer = (double*)malloc(sizeof(double) * utils->channels);
+    queue = new SampleQueue(utils->bufferLength * utils->channels * (options.lookahead.value_or(4) + 1));
 
-        for (size_t i = 0; i < frames; i++)
-        {
-            utils->time = i * utils->timeStep;
+    double* block = (double*)malloc(sizeof(double) * utils->bufferLength * utils->channels);
 
-            program->processAudioSources(buffer);
-        }
+    renderAhead(block);
 
-        free(buffer);
-    }
+    free(block);
 
     if (audio.startStream())
     {
@@ -107,6 +121,10 @@ void Organic::startPlayback()
         throw OrganicAudioException(audio.getErrorText());
     }
 
+    rendering = true;
+
+    std::thread renderer(&Organic::render, this);
+
     if (options.time.has_value())
     {
         std::this_thread::sleep_for(std::chrono::milliseconds((long long)options.time.value()));
@@ -129,6 +147,20 @@ void Organic::startPlayback()
     {
         audio.closeStream();
     }
+
+    rendering = false;
+
+    renderer.join();
+
+    if (underruns > 0)
+    {
+        Utils::printWarning(std::to_string(underruns) + " audio buffers were not rendered in time.");
+    }
+
+    if (options.saveState)
+    {
+        saveState();
+    }
 }
 
 void Organic::startExport()
@@ -137,22 +169,45 @@ void Organic::startExport()
 
     SndfileHandle* file = new SndfileHandle(options.exportPath.value().string(), SFM_WRITE, SF_FORMAT_WAV | SF_FORMAT_PCM_24, utils->channels, utils->sampleRate);
 
-    double* samples = (double*)malloc(sizeof(double) * steps * utils->channels);
+    const size_t chunkLength = std::max<size_t>(std::min((size_t)utils->sampleRate, steps), 1);
+    const size_t length = chunkLength * utils->channels;
+
+    queue = new SampleQueue(length * 2);
+
+    double* chunk = (double*)malloc(sizeof(double) * length);
 
     program->start(0);
 
-    for (size_t i = 0; i < steps; i++)
+    if (options.loadState)
+    {
+        loadState();
+    }
+
+    rendering = true;
+
+    std::thread writer(&Organic::writeExport, this, file, length);
+
+    for (size_t i = 0; i < steps && !exportFailed; i += chunkLength)
     {
-        utils->time = i * utils->timeStep;
+        const size_t frames = std::min(chunkLength, steps - i);
+
+        program->processBlock(chunk, frames);
 
-        program->processAudioSources(samples + i * utils->channels);
+        while (queue->space() < frames * utils->channels && !exportFailed)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        queue->write(chunk, frames * utils->channels);
     }
 
-    const sf_count_t written = file->write(samples, steps * utils->channels);
+    rendering = false;
+
+    writer.join();
 
-    free(samples);
+    free(chunk);
 
-    if (written != steps * utils->channels)
+    if (exportFailed)
     {
         const std::string error = file->strError();
 
@@ -162,15 +217,112 @@ void Organic::startExport()
     }
 
     delete file;
+
+    if (options.saveState)
+    {
+        saveState();
+    }
+}
+
+void Organic::loadState()
+{
+    std::ifstream file(options.loadState.value().string(), std::ios::binary);
+
+    const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (!file.good() && !file.eof())
+    {
+        throw OrganicFileException("Could not read state file \"" + options.loadState.value().string() + "\".");
+    }
+
+    program->restore(data);
+}
+
+void Organic::saveState() const
+{
+    const std::vector<char> data = program->save();
+
+    std::ofstream file(options.saveState.value().string(), std::ios::binary);
+
+    file.write(data.data(), data.size());
+
+    if (!file.good())
+    {
+        throw OrganicFileException("Could not write state file \"" + options.saveState.value().string() + "\".");
+    }
+}
+
+void Organic::render()
+{
+    double* block = (double*)malloc(sizeof(double) * utils->bufferLength * utils->channels);
+
+    const std::chrono::microseconds period((long long)(500000.0 * utils->bufferLength / utils->sampleRate));
+
+    while (rendering)
+    {
+        renderAhead(block);
+
+        std::this_thread::sleep_for(period);
+    }
+
+    free(block);
+
+    Engine::Defaults::deinit();
+}
+
+void Organic::renderAhead(double* block)
+{
+    const size_t length = utils->bufferLength * utils->channels;
+
+    while (queue->space() >= length)
+    {
+        program->processBlock(block, utils->bufferLength);
+
+        queue->write(block, length);
+    }
+}
+
+void Organic::writeExport(SndfileHandle* file, const size_t length)
+{
+    double* chunk = (double*)malloc(sizeof(double) * length);
+
+    while (true)
+    {
+        const size_t count = queue->read(chunk, length);
+
+        if (count > 0)
+        {
+            if (file->write(chunk, count) != (sf_count_t)count)
+            {
+                exportFailed = true;
+
+                break;
+            }
+
+            continue;
+        }
+
+        if (!rendering && queue->available() == 0)
+        {
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    free(chunk);
 }
 
 int Organic::processAudio(void* output, const unsigned int frames)
 {
-    for (size_t i = 0; i < frames; i++)
+    const size_t length = frames * utils->channels;
+    const size_t read = queue->read((double*)output, length);
+
+    if (read < length)
     {
-        program->processAudioSources((double*)output + i * utils->channels);
+        memset((double*)output + read, 0, sizeof(double) * (length - read));
 
-        utils->time += utils->timeStep;
+        underruns++;
     }
 
     return 0;
@@ -2,11 +2,30 @@
 
 using namespace Engine;
 
-Program::Program(const std::vector<ValueObject*>& variables, const std::vector<ValueObject*>& audioSources) :
-    variables(variables), audioSources(audioSources) {}
+Program::Program(const std::vector<ValueObject*>& variables, const std::vector<ValueObject*>& audioSources, const std::vector<std::vector<ValueObject*>>& sourceGroups, const std::vector<Utils*>& contexts, Arena* arena) :
+    variables(variables), audioSources(audioSources), sourceGroups(sourceGroups), contexts(contexts), blockLength(std::max(utils->bufferLength, 1U)), arena(arena)
+{
+    groupBuffer = (double*)malloc(sizeof(double) * blockLength * utils->channels * sourceGroups.size());
+
+    if (utils->threads > 1 && sourceGroups.size() > 1)
+    {
+        workers = new WorkerPool(std::min<size_t>(utils->threads, sourceGroups.size()));
+
+        groupCosts.resize(sourceGroups.size(), 0);
+    }
+
+    createBanks();
+}
 
 Program::~Program()
 {
+    delete workers;
+
+    for (const OscillatorBank* bank : banks)
+    {
+        delete bank;
+    }
+
     for (const ValueObject* variable : variables)
     {
         delete variable;
@@ -16,23 +35,476 @@ Program::~Program()
     {
         delete audioSource;
     }
+
+    for (const Utils* context : contexts)
+    {
+        delete context;
+    }
+
+    free(groupBuffer);
+
+    delete arena;
 }
 
-void Program::processAudioSources(double* buffer) const
+void Program::processBlock(double* buffer, const size_t frames)
 {
-    memset(buffer, 0, sizeof(double) * utils->channels);
+    Utils* previous = Utils::set(utils);
+
+    memset(buffer, 0, sizeof(double) * frames * utils->channels);
+
+    for (size_t offset = 0; offset < frames; offset += blockLength)
+    {
+        const size_t length = std::min(blockLength, frames - offset);
+
+        double* output = buffer + offset * utils->channels;
+
+        if (workers)
+        {
+            planTasks();
+
+            const size_t tasks = batches.size();
+            const size_t slices = taskCosts.size() - tasks;
+
+            workers->run(taskCosts, dependencies, [this, output, length, tasks, slices](const size_t index)
+            {
+                if (index >= tasks)
+                {
+                    const size_t slice = index - tasks;
+
+                    mixGroups(output, length * slice / slices, length * (slice + 1) / slices);
+
+                    return;
+                }
+
+                for (const size_t group : batches[index])
+                {
+                    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+                    renderGroup(group, length);
+
+                    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+                    groupCosts[group] = groupCosts[group] * 0.9 + elapsed.count() / length * 0.1;
+                }
+            });
+        }
+
+        else
+        {
+            for (size_t i = 0; i < sourceGroups.size(); i++)
+            {
+                renderGroup(i, length);
+            }
+
+            mixGroups(output, 0, length);
+        }
+
+        utils->setFrame(utils->frame + length);
+    }
+
+    Utils::set(previous);
+}
+
+void Program::seek(const size_t frames)
+{
+    const size_t preroll = std::min(frames, getTail());
+
+    Utils* previous = Utils::set(utils);
+
+    for (size_t i = 0; i < sourceGroups.size(); i++)
+    {
+        skipGroup(i, frames - preroll);
+    }
+
+    utils->setFrame(utils->frame + frames - preroll);
+
+    Utils::set(previous);
+
+    double* buffer = (double*)malloc(sizeof(double) * blockLength * utils->channels);
+
+    for (size_t i = 0; i < preroll; i += blockLength)
+    {
+        processBlock(buffer, std::min(blockLength, preroll - i));
+    }
+
+    free(buffer);
+}
+
+size_t Program::getMemoryUsage() const
+{
+    return arena ? arena->getSize() : 0;
+}
+
+std::vector<char> Program::save()
+{
+    Snapshot snapshot;
+
+    snapshot.object(this);
+
+    return snapshot.getData();
+}
+
+void Program::restore(const std::vector<char>& data)
+{
+    Snapshot snapshot(data);
+
+    snapshot.object(this);
+    snapshot.finish();
+}
+
+void Program::serialize(Snapshot& snapshot)
+{
+    size_t seed = utils->seed;
+    size_t frame = utils->frame;
+
+    unsigned int channels = utils->channels;
+    unsigned int sampleRate = utils->sampleRate;
+
+    snapshot.value(seed);
+    snapshot.value(channels);
+    snapshot.value(sampleRate);
+
+    if (seed != utils->seed || channels != utils->channels || sampleRate != utils->sampleRate)
+    {
+        throw OrganicFileException("Could not restore state, the snapshot was saved with a different seed, channel count or sample rate.");
+    }
+
+    ValueObject::serialize(snapshot);
+
+    snapshot.value(frame);
+
+    utils->setFrame(frame);
+
+    if (snapshot.isRestoring())
+    {
+        utils->generation++;
+    }
+
+    for (Utils* context : contexts)
+    {
+        context->setFrame(frame);
+
+        if (snapshot.isRestoring())
+        {
+            context->generation++;
+        }
+    }
+
+    for (ValueObject* variable : variables)
+    {
+        snapshot.object(variable);
+    }
 
     for (ValueObject* audioSource : audioSources)
     {
-        audioSource->update();
-        audioSource->getLeafAs<AudioSource>()->fillBuffer(buffer);
+        snapshot.object(audioSource);
     }
 }
 
 void Program::init()
 {
+    for (Utils* context : contexts)
+    {
+        context->setFrame(utils->frame);
+    }
+
     for (ValueObject* audioSource : audioSources)
     {
         audioSource->start(startTime);
     }
 }
+
+void Program::createBanks()
+{
+    banks.resize(sourceGroups.size(), nullptr);
+    banked.resize(sourceGroups.size(), false);
+
+    std::vector<size_t> candidates;
+
+    for (size_t i = 0; i < sourceGroups.size(); i++)
+    {
+        if (std::all_of(sourceGroups[i].begin(), sourceGroups[i].end(), [](const ValueObject* source)
+        {
+            const Oscillator* oscillator = dynamic_cast<const Oscillator*>(source);
+
+            return oscillator && oscillator->isBankable();
+        }))
+        {
+            candidates.push_back(i);
+        }
+    }
+
+    // independent groups are banked together, split into one bank per
+    // worker so that rendering them still runs in parallel, each group keeps
+    // its own buffer so the split does not change the mix
+
+    const size_t chunks = std::min<size_t>(workers ? workers->getThreads() : 1, candidates.size());
+
+    for (size_t i = 0; i < chunks; i++)
+    {
+        std::vector<Oscillator*> oscillators;
+        std::vector<Utils*> bankContexts;
+        std::vector<size_t> groups;
+
+        const size_t start = candidates.size() * i / chunks;
+        const size_t end = candidates.size() * (i + 1) / chunks;
+
+        for (size_t j = start; j < end; j++)
+        {
+            for (ValueObject* source : sourceGroups[candidates[j]])
+            {
+                oscillators.push_back(dynamic_cast<Oscillator*>(source));
+                bankContexts.push_back(contexts[candidates[j]]);
+                groups.push_back(candidates[j]);
+            }
+        }
+
+        if (oscillators.size() < 2)
+        {
+            continue;
+        }
+
+        banks[candidates[start]] = new OscillatorBank(oscillators, bankContexts, groups);
+
+        for (size_t j = start + 1; j < end; j++)
+        {
+            banked[candidates[j]] = true;
+        }
+    }
+}
+
+void Program::planTasks()
+{
+    // groups are packed in order into render tasks of roughly equal measured
+    // cost, so cheap groups share a task instead of each paying the
+    // scheduling overhead, while expensive groups still get a task each
+
+    double total = 0;
+
+    for (const double cost : groupCosts)
+    {
+        total += cost;
+    }
+
+    const double target = total / (workers->getThreads() * tasksPerWorker);
+
+    batches.clear();
+    taskCosts.clear();
+
+    for (size_t i = 0; i < sourceGroups.size(); i++)
+    {
+        if (batches.empty() || taskCosts.back() >= target)
+        {
+            batches.emplace_back();
+            taskCosts.push_back(0);
+        }
+
+        batches.back().push_back(i);
+        taskCosts.back() += groupCosts[i];
+    }
+
+    const size_t tasks = batches.size();
+
+    // one mix task per worker, each summing a slice of frames from every
+    // group buffer once all render tasks are done
+
+    taskCosts.resize(tasks + workers->getThreads(), 0);
+
+    if (dependencies.size() != taskCosts.size())
+    {
+        dependencies.assign(taskCosts.size(), {});
+
+        for (size_t i = tasks; i < dependencies.size(); i++)
+        {
+            for (size_t j = 0; j < tasks; j++)
+            {
+                dependencies[i].push_back(j);
+            }
+        }
+    }
+}
+
+void Program::renderGroup(const size_t index, const size_t frames)
+{
+    const std::vector<ValueObject*>& group = sourceGroups[index];
+
+    if (banked[index])
+    {
+        // rendered along with the first group in its bank
+
+        return;
+    }
+
+    Utils* context = contexts[index];
+
+    Utils* previous = Utils::set(context);
+
+    double* buffer = groupBuffer + index * blockLength * utils->channels;
+
+    context->setFrame(utils->frame);
+
+    if (OscillatorBank* bank = banks[index])
+    {
+        bank->renderBlock(groupBuffer, blockLength * utils->channels, utils->frame, frames);
+
+        Utils::set(previous);
+
+        return;
+    }
+
+    memset(buffer, 0, sizeof(double) * frames * utils->channels);
+
+    if (group.size() == 1)
+    {
+        renderSource(group[0], context, buffer, frames);
+    }
+
+    else
+    {
+        for (size_t i = 0; i < frames; i++)
+        {
+            context->setFrame(utils->frame + i);
+
+            for (ValueObject* source : group)
+            {
+                renderSource(source, context, buffer + i * utils->channels, 1);
+            }
+        }
+    }
+
+    Utils::set(previous);
+}
+
+void Program::mixGroups(double* buffer, const size_t start, const size_t end)
+{
+    for (size_t i = 0; i < sourceGroups.size(); i++)
+    {
+        const double* input = groupBuffer + i * blockLength * utils->channels;
+
+        for (size_t j = start * utils->channels; j < end * utils->channels; j++)
+        {
+            buffer[j] += input[j];
+        }
+    }
+}
+
+void Program::renderSource(ValueObject* source, Utils* context, double* buffer, const size_t frames)
+{
+    if (AudioSource* audioSource = dynamic_cast<AudioSource*>(source))
+    {
+        audioSource->fillBlock(buffer, frames);
+
+        return;
+    }
+
+    const size_t start = context->frame;
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        context->setFrame(start + i);
+
+        source->update();
+        source->getLeafAs<AudioSource>()->fillBuffer(buffer + i * utils->channels);
+    }
+
+    context->setFrame(start);
+}
+
+void Program::skipGroup(const size_t index, const size_t frames)
+{
+    const std::vector<ValueObject*>& group = sourceGroups[index];
+
+    Utils* context = contexts[index];
+
+    Utils* previous = Utils::set(context);
+
+    const size_t target = utils->frame + frames;
+
+    // a phase that integrates a changing frequency can only be advanced
+    // exactly by stepping through the skipped frames, so a group with such a
+    // source steps all of its sources in blocks without generating output,
+    // while other groups jump to the target and catch up on transitions
+
+    if (!std::all_of(group.begin(), group.end(), [](const ValueObject* source)
+    {
+        const AudioSource* audioSource = dynamic_cast<const AudioSource*>(source);
+
+        return !audioSource || audioSource->isSkippable();
+    }))
+    {
+        for (size_t offset = 0; offset < frames; offset += blockLength)
+        {
+            const size_t length = std::min(blockLength, frames - offset);
+
+            context->setFrame(utils->frame + offset);
+
+            for (ValueObject* source : group)
+            {
+                if (AudioSource* audioSource = dynamic_cast<AudioSource*>(source))
+                {
+                    audioSource->step(length);
+                }
+
+                else
+                {
+                    source->updateBlock(length);
+                }
+            }
+        }
+
+        context->setFrame(target);
+
+        Utils::set(previous);
+
+        return;
+    }
+
+    size_t skipped = frames;
+
+    context->seeking = true;
+    context->setFrame(target);
+
+    for (size_t i = 0; i <= frames; i++)
+    {
+        const size_t transitions = context->transitions;
+
+        context->generation++;
+
+        for (ValueObject* source : sourceGroups[index])
+        {
+            if (AudioSource* audioSource = dynamic_cast<AudioSource*>(source))
+            {
+                audioSource->skip(skipped);
+            }
+
+            else
+            {
+                source->update();
+            }
+        }
+
+        skipped = 0;
+
+        if (context->transitions == transitions)
+        {
+            break;
+        }
+    }
+
+    context->seeking = false;
+    context->generation++;
+
+    Utils::set(previous);
+}
+
+size_t Program::getTail()
+{
+    double tail = 0;
+
+    for (ValueObject* source : audioSources)
+    {
+        tail = std::max(tail, source->getLeafAs<AudioSource>()->getTail());
+    }
+
+    return tail * utils->sampleRate / 1000;
+}
@@ -0,0 +1,54 @@
+#include "../include/queue.h"
+
+SampleQueue::SampleQueue(const size_t capacity) :
+    capacity(capacity)
+{
+    buffer = (double*)calloc(capacity, sizeof(double));
+}
+
+SampleQueue::~SampleQueue()
+{
+    free(buffer);
+}
+
+size_t SampleQueue::write(const double* samples, const size_t count)
+{
+    const size_t start = head.load(std::memory_order_relaxed);
+    const size_t length = std::min(count, capacity - (start - tail.load(std::memory_order_acquire)));
+
+    const size_t offset = start % capacity;
+    const size_t first = std::min(length, capacity - offset);
+
+    memcpy(buffer + offset, samples, sizeof(double) * first);
+    memcpy(buffer, samples + first, sizeof(double) * (length - first));
+
+    head.store(start + length, std::memory_order_release);
+
+    return length;
+}
+
+size_t SampleQueue::read(double* samples, const size_t count)
+{
+    const size_t start = tail.load(std::memory_order_relaxed);
+    const size_t length = std::min(count, head.load(std::memory_order_acquire) - start);
+
+    const size_t offset = start % capacity;
+    const size_t first = std::min(length, capacity - offset);
+
+    memcpy(samples, buffer + offset, sizeof(double) * first);
+    memcpy(samples + first, buffer, sizeof(double) * (length - first));
+
+    tail.store(start + length, std::memory_order_release);
+
+    return length;
+}
+
+size_t SampleQueue::available() const
+{
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+}
+
+size_t SampleQueue::space() const
+{
+    return capacity - available();
+}
@@ -0,0 +1,68 @@
+#include "../include/random.h"
+#include "../include/utils.h"
+
+using namespace Engine;
+
+RandomStream::RandomStream()
+{
+    Utils* utils = Utils::get();
+
+    *this = RandomStream(utils->seed, utils->streams++);
+}
+
+RandomStream::RandomStream(const uint64_t seed, const uint64_t stream) :
+    key { (uint32_t)seed, (uint32_t)(seed >> 32) }, stream(stream) {}
+
+RandomStream::result_type RandomStream::operator()()
+{
+    const uint64_t block = counter >> 1;
+
+    if (block != cachedBlock)
+    {
+        generate(block);
+    }
+
+    return cached[counter++ & 1];
+}
+
+double RandomStream::uniform()
+{
+    return ((*this)() >> 11) * 0x1.0p-53;
+}
+
+double RandomStream::uniform(const double min, const double max)
+{
+    return min + uniform() * (max - min);
+}
+
+size_t RandomStream::index(const size_t max)
+{
+    const size_t value = uniform() * ((double)max + 1);
+
+    return value > max ? max : value;
+}
+
+void RandomStream::generate(const uint64_t block)
+{
+    uint32_t words[4] = { (uint32_t)block, (uint32_t)(block >> 32), (uint32_t)stream, (uint32_t)(stream >> 32) };
+    uint32_t round[2] = { key[0], key[1] };
+
+    for (size_t i = 0; i < 10; i++)
+    {
+        const uint64_t first = (uint64_t)0xD2511F53 * words[0];
+        const uint64_t second = (uint64_t)0xCD9E8D57 * words[2];
+
+        words[0] = (uint32_t)(second >> 32) ^ words[1] ^ round[0];
+        words[1] = (uint32_t)second;
+        words[2] = (uint32_t)(first >> 32) ^ words[3] ^ round[1];
+        words[3] = (uint32_t)first;
+
+        round[0] += 0x9E3779B9;
+        round[1] += 0xBB67AE85;
+    }
+
+    cached[0] = words[0] | (uint64_t)words[1] << 32;
+    cached[1] = words[2] | (uint64_t)words[3] << 32;
+
+    cachedBlock = block;
+}
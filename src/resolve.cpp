@@ -361,6 +361,14 @@ void TypeResolver::resolveTypes(const Reverb* token)
     token->arguments->check();
 }
 
+void TypeResolver::resolveTypes(const Convolve* token)
+{
+    resolveArgumentTypes(token->arguments, "mix", new NumberType(), new Value(token->location, 1));
+    resolveArgumentTypes(token->arguments, "impulse", new StringType());
+
+    token->arguments->check();
+}
+
 void TypeResolver::resolveTypes(const CallUser* token)
 {
     for (const InputDef* input : token->function->inputs)
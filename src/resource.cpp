@@ -2,8 +2,10 @@
 
 using namespace Engine;
 
-Resource::Resource(const Path& path, const SourceLocation& location)
+ResourceData::ResourceData(const Path& path, const SourceLocation& location, const std::optional<Path>& cacheDirectory)
 {
+    const Utils* utils = Utils::get();
+
     if (!path.exists())
     {
         throw OrganicParseException("Audio file \"" + path.string() + "\" does not exist.", location);
@@ -14,84 +16,124 @@ Resource::Resource(const Path& path, const SourceLocation& location)
         throw OrganicParseException("\"" + path.string() + "\" is not a file.", location);
     }
 
-    SndfileHandle* file = new SndfileHandle(path.string());
+    std::optional<ResourceCache> cache;
+
+    if (cacheDirectory)
+    {
+        cache.emplace(cacheDirectory.value(), path, utils->sampleRate, utils->channels);
+
+        mapping = cache->load(samples, frames);
+
+        if (mapping)
+        {
+            return;
+        }
+    }
+
+    SndfileHandle file(path.string());
 
-    const sf_count_t length = file->frames() * file->channels();
+    const int sampleRate = file.samplerate();
+    const int channels = file.channels();
 
-    const int sampleRate = file->samplerate();
-    const int channels = file->channels();
+    sf_count_t length = file.frames();
 
-    float* floatSamples = (float*)malloc(sizeof(float) * length);
+    float* interleaved = (float*)malloc(sizeof(float) * length * channels);
 
-    if (file->read(floatSamples, length) != length)
+    if (file.read(interleaved, length * channels) != length * channels)
     {
-        throw OrganicFileException("Could not read audio file \"" + path.string() + "\": " + std::string(file->strError()));
-    }
+        free(interleaved);
 
-    sf_count_t scaledLength = length;
+        throw OrganicFileException("Could not read audio file \"" + path.string() + "\": " + std::string(file.strError()));
+    }
 
     if (sampleRate != utils->sampleRate)
     {
-        scaledLength = length * (float)utils->sampleRate / sampleRate;
+        const sf_count_t scaledLength = length * (double)utils->sampleRate / sampleRate;
 
-        float* scaledSamples = (float*)malloc(sizeof(float) * scaledLength);
+        float* scaled = (float*)malloc(sizeof(float) * scaledLength * channels);
 
         SRC_DATA data;
 
-        data.data_in = floatSamples;
-        data.data_out = scaledSamples;
-        data.input_frames = length / channels;
-        data.output_frames = scaledLength / channels;
+        data.data_in = interleaved;
+        data.data_out = scaled;
+        data.input_frames = length;
+        data.output_frames = scaledLength;
         data.src_ratio = (double)utils->sampleRate / sampleRate;
 
         const int result = src_simple(&data, SRC_SINC_BEST_QUALITY, channels);
 
+        free(interleaved);
+
         if (result)
         {
+            free(scaled);
+
             throw OrganicFileException(std::string("Failed to convert sample rate of audio file \"" + path.string() + "\": ") + src_strerror(result));
         }
 
-        free(floatSamples);
-
-        floatSamples = scaledSamples;
-        scaledLength = data.output_frames_gen * utils->channels;
+        interleaved = scaled;
+        length = data.output_frames_gen;
     }
 
-    this->length = scaledLength;
+    frames = length;
 
-    samples = (double*)malloc(sizeof(double) * scaledLength);
+    samples = mix(interleaved, frames, channels, utils->channels);
 
-    if (channels == utils->channels)
+    free(interleaved);
+
+    if (cache)
     {
-        for (sf_count_t i = 0; i < scaledLength; i++)
-        {
-            samples[i] = floatSamples[i];
-        }
+        cache->store(samples, frames);
     }
+}
 
-    else if (channels == 1)
+float* ResourceData::mix(const float* interleaved, const size_t frames, const unsigned int inputChannels, const unsigned int outputChannels)
+{
+    float* planar = (float*)calloc(frames * outputChannels, sizeof(float));
+
+    if (inputChannels == 1)
     {
-        for (sf_count_t i = 0; i < scaledLength; i++)
+        for (size_t i = 0; i < outputChannels; i++)
         {
-            samples[i] = floatSamples[i / 2] / 2;
+            float* output = planar + i * frames;
+
+            for (size_t j = 0; j < frames; j++)
+            {
+                output[j] = interleaved[j] / outputChannels;
+            }
         }
+
+        return planar;
     }
 
-    else
+    for (size_t i = 0; i < inputChannels; i++)
     {
-        for (sf_count_t i = 0; i < scaledLength; i++)
+        float* output = planar + (i % outputChannels) * frames;
+
+        for (size_t j = 0; j < frames; j++)
         {
-            samples[i / 2] += floatSamples[i];
+            output[j] += interleaved[j * inputChannels + i];
         }
     }
 
-    free(floatSamples);
+    return planar;
 }
 
-Resource::Resource() :
-    samples(nullptr), length(0) {}
-
-Resource::~Resource()
+ResourceData::~ResourceData()
 {
-    free(samples);
+    if (mapping)
+    {
+        delete mapping;
+    }
+
+    else
+    {
+        free(samples);
+    }
 }
+
+Resource::Resource(const SharedResourceData& data) :
+    samples(data->samples), frames(data->frames), data(data) {}
+
+Resource::Resource() :
+    samples(nullptr), frames(0) {}
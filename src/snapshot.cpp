@@ -0,0 +1,116 @@
+#include "../include/object.h"
+#include "../include/snapshot.h"
+
+using namespace Engine;
+
+Snapshot::Snapshot() :
+    restoring(false)
+{
+    uint32_t magic = Snapshot::magic;
+    uint32_t version = Snapshot::version;
+
+    value(magic);
+    value(version);
+}
+
+Snapshot::Snapshot(const std::vector<char>& data) :
+    data(data), restoring(true)
+{
+    uint32_t magic = 0;
+    uint32_t version = 0;
+
+    if (data.size() < sizeof(magic) + sizeof(version))
+    {
+        throw OrganicFileException("Could not restore state, the file is not a snapshot.");
+    }
+
+    value(magic);
+    value(version);
+
+    if (magic == swappedMagic)
+    {
+        throw OrganicFileException("Could not restore state, the snapshot was saved on a machine with a different byte order.");
+    }
+
+    if (magic != Snapshot::magic)
+    {
+        throw OrganicFileException("Could not restore state, the file is not a snapshot.");
+    }
+
+    if (version != Snapshot::version)
+    {
+        throw OrganicFileException("Could not restore state, the snapshot was saved by an incompatible version.");
+    }
+}
+
+void Snapshot::bytes(void* data, const size_t size)
+{
+    char* target = static_cast<char*>(data);
+
+    if (!restoring)
+    {
+        // the buffer is grown first so the copy is bounded by a size the
+        // compiler can see, rather than by a range insert into empty storage
+
+        const size_t end = this->data.size();
+
+        this->data.resize(end + size);
+
+        std::copy_n(target, size, this->data.begin() + end);
+
+        return;
+    }
+
+    if (size > this->data.size() - offset)
+    {
+        throw OrganicFileException("Could not restore state, the snapshot does not match the program.");
+    }
+
+    std::copy_n(this->data.begin() + offset, size, target);
+
+    offset += size;
+}
+
+void Snapshot::random(RandomStream& stream)
+{
+    uint64_t counter = stream.tell();
+
+    value(counter);
+
+    stream.seek(counter);
+}
+
+void Snapshot::object(Sync* object)
+{
+    if (object && visited.insert(object).second)
+    {
+        object->serialize(*this);
+    }
+}
+
+void Snapshot::require(const size_t count, const size_t size) const
+{
+    // counts are checked against the bytes left before anything is sized
+    // from them
+
+    if (restoring && size > 0 && count > (data.size() - offset) / size)
+    {
+        throw OrganicFileException("Could not restore state, the snapshot does not match the program.");
+    }
+}
+
+void Snapshot::expect(const bool valid) const
+{
+    if (restoring && !valid)
+    {
+        throw OrganicFileException("Could not restore state, the snapshot does not match the program.");
+    }
+}
+
+void Snapshot::finish() const
+{
+    if (restoring && offset != data.size())
+    {
+        throw OrganicFileException("Could not restore state, the snapshot does not match the program.");
+    }
+}
@@ -880,6 +880,19 @@ Engine::ValueObject* Reverb::transform(TokenTransformer* visitor) const
     return visitor->transform(this);
 }
 
+Convolve::Convolve(const SourceLocation& location, ArgumentList* arguments) :
+    Effect(location, arguments) {}
+
+void Convolve::resolveTypes() const
+{
+    TypeResolver::resolveTypes(this);
+}
+
+Engine::ValueObject* Convolve::transform(TokenTransformer* visitor) const
+{
+    return visitor->transform(this);
+}
+
 CallUser::CallUser(const SourceLocation& location, ArgumentList* arguments, const FunctionDef* function) :
     Call(location, arguments), function(function) {}
 
@@ -1,9 +1,10 @@
 #include "../include/transform.h"
 
 #define ARG(name) transformArgument(token->arguments, name)
+#define CONTROL(name) controlRate(ARG(name))
 
-TokenTransformer::TokenTransformer(const Path& sourcePath) :
-    sourcePath(sourcePath) {}
+TokenTransformer::TokenTransformer(const Path& sourcePath, const bool bytecode, const unsigned int controlPeriod, const std::optional<Path>& cacheDirectory) :
+    sourcePath(sourcePath), bytecode(bytecode), controlPeriod(controlPeriod), cacheDirectory(cacheDirectory) {}
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Value* token)
 {
@@ -22,19 +23,19 @@ Engine::ValueObject* TokenTransformer::transform(const Parser::Boolean* token)
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::VariableDef* token)
 {
-    setVariable(token, token->value->transform(this));
+    setVariable(token, share(token->value, token->value->transform(this)));
 
     return nullptr;
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::VariableRef* token)
 {
-    return new Engine::Variable(currentVariables[token->definition]);
+    return referenceVariable(token->definition);
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::InputRef* token)
 {
-    return new Engine::Variable(currentVariables[token->definition]);
+    return referenceVariable(token->definition);
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::FunctionRef* token)
@@ -50,6 +51,8 @@ Engine::ValueObject* TokenTransformer::transform(const Parser::FunctionRef* toke
         setVariable(input, placeholder);
     }
 
+    lambdaDepth++;
+
     for (size_t i = 0; i < token->definition->program->instructions.size() - 1; i++)
     {
         token->definition->program->instructions[i]->transform(this);
@@ -57,6 +60,8 @@ Engine::ValueObject* TokenTransformer::transform(const Parser::FunctionRef* toke
 
     Engine::ValueObject* value = token->definition->program->instructions.back()->transform(this);
 
+    lambdaDepth--;
+
     return new Engine::Lambda(placeholders, value);
 }
 
@@ -84,7 +89,23 @@ Engine::ValueObject* TokenTransformer::transform(const Parser::ParenthesizedExpr
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Negate* token)
 {
-    return new Engine::ValueNegate(token->value->transform(this));
+    if (bytecode)
+    {
+        return compileExpression(token);
+    }
+
+    Engine::ValueObject* value = token->value->transform(this);
+
+    if (const Engine::Value* constant = dynamic_cast<const Engine::Value*>(value))
+    {
+        const double negated = -constant->getValue();
+
+        delete value;
+
+        return new Engine::Value(negated);
+    }
+
+    return new Engine::ValueNegate(value);
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Time* token)
@@ -179,59 +200,53 @@ Engine::ValueObject* TokenTransformer::transform(const Parser::EmptyAudioSource*
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Sine* token)
 {
-    return new Engine::Sine(ARG("volume"), ARG("pan"), ARG("effects"), ARG("frequency"));
+    return new Engine::Sine(CONTROL("volume"), CONTROL("pan"), ARG("effects"), CONTROL("frequency"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Square* token)
 {
-    return new Engine::Square(ARG("volume"), ARG("pan"), ARG("effects"), ARG("frequency"));
+    return new Engine::Square(CONTROL("volume"), CONTROL("pan"), ARG("effects"), CONTROL("frequency"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Triangle* token)
 {
-    return new Engine::Triangle(ARG("volume"), ARG("pan"), ARG("effects"), ARG("frequency"));
+    return new Engine::Triangle(CONTROL("volume"), CONTROL("pan"), ARG("effects"), CONTROL("frequency"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Saw* token)
 {
-    return new Engine::Saw(ARG("volume"), ARG("pan"), ARG("effects"), ARG("frequency"));
+    return new Engine::Saw(CONTROL("volume"), CONTROL("pan"), ARG("effects"), CONTROL("frequency"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Oscillator* token)
 {
-    return new Engine::CustomOscillator(ARG("volume"), ARG("pan"), ARG("effects"), ARG("frequency"), ARG("waveform"));
+    return new Engine::CustomOscillator(CONTROL("volume"), CONTROL("pan"), ARG("effects"), CONTROL("frequency"), ARG("waveform"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Noise* token)
 {
-    return new Engine::Noise(ARG("volume"), ARG("pan"), ARG("effects"));
+    return new Engine::Noise(CONTROL("volume"), CONTROL("pan"), ARG("effects"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Sample* token)
 {
-    const Parser::Argument* file = token->arguments->findArgument("file");
-
-    const Path path = Path::beside(Path::formatPath(file->value->string()), sourcePath);
-
-    Engine::Resource* resource = new Engine::Resource(path, file->location);
+    Engine::Resource* resource = loadResource(token->arguments->findArgument("file"));
 
-    return new Engine::Sample(ARG("volume"), ARG("pan"), ARG("effects"), resource);
+    return new Engine::Sample(CONTROL("volume"), CONTROL("pan"), ARG("effects"), resource);
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Granulate* token)
 {
-    const Parser::Argument* file = token->arguments->findArgument("sample");
+    Engine::Resource* resource = loadResource(token->arguments->findArgument("sample"));
 
-    const Path path = Path::beside(Path::formatPath(file->value->string()), sourcePath);
+    const bool staticShape = isStaticShape(token->arguments->findArgument("shape")->value.get());
 
-    Engine::Resource* resource = new Engine::Resource(path, file->location);
-
-    return new Engine::Granulate(ARG("volume"), ARG("pan"), ARG("effects"), resource, ARG("grains"), ARG("length"), ARG("shape"));
+    return new Engine::Granulate(CONTROL("volume"), CONTROL("pan"), ARG("effects"), resource, ARG("grains"), ARG("length"), ARG("shape"), staticShape);
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::Group* token)
 {
-    return new Engine::Group(ARG("volume"), ARG("pan"), ARG("effects"), ARG("sources"));
+    return new Engine::Group(CONTROL("volume"), CONTROL("pan"), ARG("effects"), ARG("sources"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::EmptyEffect* token)
@@ -269,11 +284,20 @@ Engine::ValueObject* TokenTransformer::transform(const Parser::Reverb* token)
     return new Engine::Reverb(ARG("mix"), ARG("length"));
 }
 
+Engine::ValueObject* TokenTransformer::transform(const Parser::Convolve* token)
+{
+    Engine::Resource* resource = loadResource(token->arguments->findArgument("impulse"));
+
+    return new Engine::Convolve(ARG("mix"), resource);
+}
+
 Engine::ValueObject* TokenTransformer::transform(const Parser::CallUser* token)
 {
     for (const Parser::InputDef* input : token->function->inputs)
     {
-        setVariable(input, transformArgument(token->arguments, input->string()));
+        const Parser::Argument* argument = token->arguments->findArgument(input->string());
+
+        setVariable(input, argument ? share(argument->value.get(), argument->value->transform(this)) : nullptr);
     }
 
     for (size_t i = 0; i < token->function->program->instructions.size() - 1; i++)
@@ -286,52 +310,102 @@ Engine::ValueObject* TokenTransformer::transform(const Parser::CallUser* token)
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::AddAlias* token)
 {
-    return new Engine::ValueAdd(ARG("a"), ARG("b"));
+    if (bytecode)
+    {
+        return compileExpression(token);
+    }
+
+    return combine(Engine::Opcode::Add, ARG("a"), ARG("b"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::SubtractAlias* token)
 {
-    return new Engine::ValueSubtract(ARG("a"), ARG("b"));
+    if (bytecode)
+    {
+        return compileExpression(token);
+    }
+
+    return combine(Engine::Opcode::Subtract, ARG("a"), ARG("b"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::MultiplyAlias* token)
 {
-    return new Engine::ValueMultiply(ARG("a"), ARG("b"));
+    if (bytecode)
+    {
+        return compileExpression(token);
+    }
+
+    return combine(Engine::Opcode::Multiply, ARG("a"), ARG("b"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::DivideAlias* token)
 {
-    return new Engine::ValueDivide(ARG("a"), ARG("b"));
+    if (bytecode)
+    {
+        return compileExpression(token);
+    }
+
+    return combine(Engine::Opcode::Divide, ARG("a"), ARG("b"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::PowerAlias* token)
 {
-    return new Engine::ValuePower(ARG("a"), ARG("b"));
+    if (bytecode)
+    {
+        return compileExpression(token);
+    }
+
+    return combine(Engine::Opcode::Power, ARG("a"), ARG("b"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::EqualAlias* token)
 {
-    return new Engine::ValueEquals(ARG("a"), ARG("b"));
+    if (bytecode)
+    {
+        return compileExpression(token);
+    }
+
+    return combine(Engine::Opcode::Equals, ARG("a"), ARG("b"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::LessAlias* token)
 {
-    return new Engine::ValueLess(ARG("a"), ARG("b"));
+    if (bytecode)
+    {
+        return compileExpression(token);
+    }
+
+    return combine(Engine::Opcode::Less, ARG("a"), ARG("b"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::GreaterAlias* token)
 {
-    return new Engine::ValueGreater(ARG("a"), ARG("b"));
+    if (bytecode)
+    {
+        return compileExpression(token);
+    }
+
+    return combine(Engine::Opcode::Greater, ARG("a"), ARG("b"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::LessEqualAlias* token)
 {
-    return new Engine::ValueLessEqual(ARG("a"), ARG("b"));
+    if (bytecode)
+    {
+        return compileExpression(token);
+    }
+
+    return combine(Engine::Opcode::LessEqual, ARG("a"), ARG("b"));
 }
 
 Engine::ValueObject* TokenTransformer::transform(const Parser::GreaterEqualAlias* token)
 {
-    return new Engine::ValueGreaterEqual(ARG("a"), ARG("b"));
+    if (bytecode)
+    {
+        return compileExpression(token);
+    }
+
+    return combine(Engine::Opcode::GreaterEqual, ARG("a"), ARG("b"));
 }
 
 Engine::Program* TokenTransformer::transform(const Parser::Program* token)
@@ -340,22 +414,57 @@ Engine::Program* TokenTransformer::transform(const Parser::Program* token)
 
     std::vector<Engine::ValueObject*> sources;
 
-    for (const Parser::Token* instruction : token->instructions)
+    std::vector<std::unordered_set<Engine::ValueObject*>> sourceReferences;
+
+    std::vector<std::unordered_set<Engine::Sync*>> created(token->instructions.size());
+    std::vector<Engine::ValueObject*> owners(token->instructions.size(), nullptr);
+
+    std::unique_ptr<Engine::Arena> arena(new Engine::Arena());
+
     {
-        Engine::ValueObject* object = instruction->transform(this);
+        Engine::ArenaScope scope(arena.get());
 
-        if (sourceType->checkType(instruction->type().get()))
+        for (size_t i = 0; i < token->instructions.size(); i++)
         {
-            sources.push_back(object);
-        }
+            const Parser::Token* instruction = token->instructions[i];
 
-        else
-        {
-            delete object;
+            currentReferences.clear();
+
+            Engine::Sync::created = &created[i];
+
+            Engine::ValueObject* object = instruction->transform(this);
+
+            if (sourceType->checkType(instruction->type().get()))
+            {
+                sources.push_back(object);
+
+                owners[i] = object;
+
+                std::unordered_set<Engine::ValueObject*>& references = sourceReferences.emplace_back();
+
+                for (Engine::ValueObject* value : currentReferences)
+                {
+                    collectReferences(value, references);
+                }
+            }
+
+            else if (const Parser::VariableDef* definition = dynamic_cast<const Parser::VariableDef*>(instruction))
+            {
+                owners[i] = currentVariables[definition];
+            }
+
+            else
+            {
+                delete object;
+            }
         }
     }
 
-    return new Engine::Program(allVariables, sources);
+    const std::vector<std::vector<Engine::ValueObject*>> groups = groupSources(sources, sourceReferences);
+
+    const std::vector<Utils*> contexts = createContexts(groups, sources, sourceReferences, created, owners);
+
+    return new Engine::Program(allVariables, sources, groups, contexts, arena.release());
 }
 
 Engine::ValueObject* TokenTransformer::transformArgument(const Parser::ArgumentList* arguments, const std::string& name)
@@ -371,9 +480,392 @@ Engine::ValueObject* TokenTransformer::transformArgument(const Parser::ArgumentL
     return nullptr;
 }
 
+Engine::ValueObject* TokenTransformer::controlRate(Engine::ValueObject* value) const
+{
+    if (controlPeriod <= 1 || !value || value->getRate() != Constants::Control)
+    {
+        return value;
+    }
+
+    return new Engine::ControlRate(value, controlPeriod);
+}
+
+Engine::Resource* TokenTransformer::loadResource(const Parser::Argument* argument)
+{
+    const Parser::String* file = dynamic_cast<const Parser::String*>(argument->value.get());
+
+    if (!file)
+    {
+        throw OrganicParseException("The audio file for input \"" + argument->name + "\" must be a string literal.", argument->value->location);
+    }
+
+    const Path path = Path::beside(Path::formatPath(file->str), sourcePath);
+
+    if (!resources.count(path))
+    {
+        resources.emplace(path, Engine::SharedResourceData(new Engine::ResourceData(path, argument->location, cacheDirectory)));
+    }
+
+    return new Engine::Resource(resources.at(path));
+}
+
+bool TokenTransformer::isStaticShape(const Parser::Token* token) const
+{
+    if (const Parser::EmptyLambda* lambda = dynamic_cast<const Parser::EmptyLambda*>(token))
+    {
+        return isPure(lambda->value, {});
+    }
+
+    if (const Parser::FunctionRef* function = dynamic_cast<const Parser::FunctionRef*>(token))
+    {
+        return isPure(function->definition->program->instructions.back(), function->definition->inputs);
+    }
+
+    return false;
+}
+
+bool TokenTransformer::isPure(const Parser::Token* token, const std::vector<const Parser::InputDef*>& inputs) const
+{
+    if (dynamic_cast<const Parser::Value*>(token) || dynamic_cast<const Parser::Constant*>(token) || dynamic_cast<const Parser::Boolean*>(token))
+    {
+        return true;
+    }
+
+    if (const Parser::InputRef* input = dynamic_cast<const Parser::InputRef*>(token))
+    {
+        return std::find(inputs.begin(), inputs.end(), input->definition) != inputs.end();
+    }
+
+    if (const Parser::VariableRef* variable = dynamic_cast<const Parser::VariableRef*>(token))
+    {
+        return isPure(variable->definition->value, inputs);
+    }
+
+    if (const Parser::ParenthesizedExpression* expression = dynamic_cast<const Parser::ParenthesizedExpression*>(token))
+    {
+        return isPure(expression->value, inputs);
+    }
+
+    if (const Parser::Negate* negate = dynamic_cast<const Parser::Negate*>(token))
+    {
+        return isPure(negate->value, inputs);
+    }
+
+    if (const Parser::List* list = dynamic_cast<const Parser::List*>(token))
+    {
+        for (const Parser::Token* value : list->values)
+        {
+            if (!isPure(value, inputs))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    if (dynamic_cast<const Parser::CallAlias*>(token) || dynamic_cast<const Parser::Min*>(token) || dynamic_cast<const Parser::Max*>(token) || dynamic_cast<const Parser::Round*>(token) || dynamic_cast<const Parser::Absolute*>(token))
+    {
+        for (const Parser::Argument* argument : static_cast<const Parser::Call*>(token)->arguments->arguments)
+        {
+            if (!isPure(argument->value.get(), inputs))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+Engine::ValueObject* TokenTransformer::compileExpression(const Parser::Token* token)
+{
+    Engine::ExpressionBuilder builder;
+
+    return builder.build(compileOperand(token, builder));
+}
+
+size_t TokenTransformer::compileOperand(const Parser::Token* token, Engine::ExpressionBuilder& builder)
+{
+    static const std::unordered_map<std::type_index, Engine::Opcode> opcodes =
+    {
+        { typeid(Parser::AddAlias), Engine::Opcode::Add },
+        { typeid(Parser::SubtractAlias), Engine::Opcode::Subtract },
+        { typeid(Parser::MultiplyAlias), Engine::Opcode::Multiply },
+        { typeid(Parser::DivideAlias), Engine::Opcode::Divide },
+        { typeid(Parser::PowerAlias), Engine::Opcode::Power },
+        { typeid(Parser::EqualAlias), Engine::Opcode::Equals },
+        { typeid(Parser::LessAlias), Engine::Opcode::Less },
+        { typeid(Parser::GreaterAlias), Engine::Opcode::Greater },
+        { typeid(Parser::LessEqualAlias), Engine::Opcode::LessEqual },
+        { typeid(Parser::GreaterEqualAlias), Engine::Opcode::GreaterEqual }
+    };
+
+    if (const Parser::ParenthesizedExpression* expression = dynamic_cast<const Parser::ParenthesizedExpression*>(token))
+    {
+        return compileOperand(expression->value, builder);
+    }
+
+    if (const Parser::Value* value = dynamic_cast<const Parser::Value*>(token))
+    {
+        return builder.constant(value->value);
+    }
+
+    if (const Parser::Negate* negate = dynamic_cast<const Parser::Negate*>(token))
+    {
+        return builder.unary(Engine::Opcode::Negate, compileOperand(negate->value, builder));
+    }
+
+    if (const Parser::CallAlias* alias = dynamic_cast<const Parser::CallAlias*>(token))
+    {
+        const size_t a = compileOperand(alias->arguments->findArgument("a")->value.get(), builder);
+        const size_t b = compileOperand(alias->arguments->findArgument("b")->value.get(), builder);
+
+        return builder.binary(opcodes.at(typeid(*alias)), a, b);
+    }
+
+    Engine::ValueObject* value = token->transform(this);
+
+    if (const Engine::Value* constant = dynamic_cast<const Engine::Value*>(value))
+    {
+        const size_t output = builder.constant(constant->getValue());
+
+        delete value;
+
+        return output;
+    }
+
+    return builder.load(value);
+}
+
+Engine::ValueObject* TokenTransformer::combine(const Engine::Opcode& opcode, Engine::ValueObject* a, Engine::ValueObject* b) const
+{
+    const Engine::Value* constantA = dynamic_cast<const Engine::Value*>(a);
+    const Engine::Value* constantB = dynamic_cast<const Engine::Value*>(b);
+
+    if (constantA && constantB)
+    {
+        const double value = Engine::Expression::evaluate(opcode, constantA->getValue(), constantB->getValue());
+
+        delete a;
+        delete b;
+
+        return new Engine::Value(value);
+    }
+
+    if (constantA && Engine::Expression::isLeftIdentity(opcode, constantA->getValue()))
+    {
+        delete a;
+
+        return b;
+    }
+
+    if (constantB && Engine::Expression::isRightIdentity(opcode, constantB->getValue()))
+    {
+        delete b;
+
+        return a;
+    }
+
+    if (opcode == Engine::Opcode::Power && constantB && constantB->getValue() == 2)
+    {
+        delete b;
+
+        return new Engine::ValueSquare(a);
+    }
+
+    switch (opcode)
+    {
+        case Engine::Opcode::Add:
+            return new Engine::ValueAdd(a, b);
+
+        case Engine::Opcode::Subtract:
+            return new Engine::ValueSubtract(a, b);
+
+        case Engine::Opcode::Multiply:
+            return new Engine::ValueMultiply(a, b);
+
+        case Engine::Opcode::Divide:
+            return new Engine::ValueDivide(a, b);
+
+        case Engine::Opcode::Power:
+            return new Engine::ValuePower(a, b);
+
+        case Engine::Opcode::Equals:
+            return new Engine::ValueEquals(a, b);
+
+        case Engine::Opcode::Less:
+            return new Engine::ValueLess(a, b);
+
+        case Engine::Opcode::Greater:
+            return new Engine::ValueGreater(a, b);
+
+        case Engine::Opcode::LessEqual:
+            return new Engine::ValueLessEqual(a, b);
+
+        default:
+            return new Engine::ValueGreaterEqual(a, b);
+    }
+}
+
 void TokenTransformer::setVariable(const Parser::Identifier* name, Engine::ValueObject* value)
 {
     currentVariables[name] = value;
+    variableReferences[value] = currentReferences;
+
+    if (const Engine::Value* constant = dynamic_cast<const Engine::Value*>(value))
+    {
+        constants[value] = constant->getValue();
+    }
 
     allVariables.push_back(value);
 }
+
+Engine::ValueObject* TokenTransformer::share(const Parser::Token* token, Engine::ValueObject* value) const
+{
+    if (!value || lambdaDepth > 0 || dynamic_cast<const Engine::Value*>(value))
+    {
+        return value;
+    }
+
+    const Parser::TypeConstant type = token->type()->baseType();
+
+    if (type != Parser::TypeConstant::Number && type != Parser::TypeConstant::Boolean)
+    {
+        return value;
+    }
+
+    return new Engine::SharedValue(value);
+}
+
+Engine::ValueObject* TokenTransformer::referenceVariable(const Parser::Identifier* name)
+{
+    Engine::ValueObject* value = currentVariables[name];
+
+    if (constants.count(value))
+    {
+        return new Engine::Value(constants.at(value));
+    }
+
+    currentReferences.insert(value);
+
+    return new Engine::Variable(value);
+}
+
+void TokenTransformer::collectReferences(Engine::ValueObject* value, std::unordered_set<Engine::ValueObject*>& references) const
+{
+    if (!references.insert(value).second)
+    {
+        return;
+    }
+
+    if (variableReferences.count(value))
+    {
+        for (Engine::ValueObject* reference : variableReferences.at(value))
+        {
+            collectReferences(reference, references);
+        }
+    }
+}
+
+std::vector<std::vector<Engine::ValueObject*>> TokenTransformer::groupSources(const std::vector<Engine::ValueObject*>& sources, const std::vector<std::unordered_set<Engine::ValueObject*>>& references) const
+{
+    std::vector<size_t> parents(sources.size());
+
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        parents[i] = i;
+    }
+
+    const std::function<size_t(const size_t)> root = [&](const size_t index)
+    {
+        if (parents[index] != index)
+        {
+            parents[index] = root(parents[index]);
+        }
+
+        return parents[index];
+    };
+
+    std::unordered_map<Engine::ValueObject*, size_t> owners;
+
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        for (Engine::ValueObject* value : references[i])
+        {
+            if (owners.count(value))
+            {
+                parents[root(i)] = root(owners[value]);
+            }
+
+            else
+            {
+                owners[value] = i;
+            }
+        }
+    }
+
+    std::vector<std::vector<Engine::ValueObject*>> groups;
+
+    std::unordered_map<size_t, size_t> indices;
+
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        const size_t group = root(i);
+
+        if (!indices.count(group))
+        {
+            indices[group] = groups.size();
+
+            groups.emplace_back();
+        }
+
+        groups[indices[group]].push_back(sources[i]);
+    }
+
+    return groups;
+}
+
+std::vector<Utils*> TokenTransformer::createContexts(const std::vector<std::vector<Engine::ValueObject*>>& groups, const std::vector<Engine::ValueObject*>& sources, const std::vector<std::unordered_set<Engine::ValueObject*>>& references, const std::vector<std::unordered_set<Engine::Sync*>>& created, const std::vector<Engine::ValueObject*>& owners) const
+{
+    const Utils* utils = Utils::get();
+
+    std::vector<Utils*> contexts;
+
+    std::unordered_map<Engine::ValueObject*, size_t> indices;
+
+    for (size_t i = 0; i < groups.size(); i++)
+    {
+        Utils* context = new Utils(*utils);
+
+        contexts.push_back(context);
+
+        for (Engine::ValueObject* source : groups[i])
+        {
+            indices[source] = i;
+        }
+    }
+
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        for (Engine::ValueObject* value : references[i])
+        {
+            indices[value] = indices[sources[i]];
+        }
+    }
+
+    for (size_t i = 0; i < owners.size(); i++)
+    {
+        if (owners[i] && indices.count(owners[i]))
+        {
+            for (Engine::Sync* object : created[i])
+            {
+                object->bind(contexts[indices[owners[i]]]);
+            }
+        }
+    }
+
+    return contexts;
+}
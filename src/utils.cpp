@@ -1,15 +1,24 @@
 #include "../include/utils.h"
 
+thread_local Utils* Utils::current = nullptr;
+
 Utils* Utils::get()
 {
-    static Utils* instance;
-
-    if (!instance)
+    if (!current)
     {
-        instance = new Utils();
+        throw std::logic_error("No render context is set on this thread, Utils::set() must be called first.");
     }
 
-    return instance;
+    return current;
+}
+
+Utils* Utils::set(Utils* utils)
+{
+    Utils* previous = current;
+
+    current = utils;
+
+    return previous;
 }
 
 void Utils::printInfo()
@@ -49,14 +58,14 @@ void Utils::parseWarning(const std::string& message, const SourceLocation& locat
 
 void Utils::printWarning(const std::string& text)
 {
-    Utils* utils = Utils::get();
+    Utils* utils = current;
 
-    if (!utils->firstPrint)
+    if (utils && !utils->firstPrint)
     {
         std::cout << "\n";
     }
 
-    else
+    else if (utils)
     {
         utils->firstPrint = false;
     }
@@ -66,14 +75,14 @@ void Utils::printWarning(const std::string& text)
 
 void Utils::printError(const std::string& text)
 {
-    Utils* utils = Utils::get();
+    Utils* utils = current;
 
-    if (!utils->firstPrint)
+    if (utils && !utils->firstPrint)
     {
         std::cout << "\n";
     }
 
-    else
+    else if (utils)
     {
         utils->firstPrint = false;
     }
@@ -85,7 +94,7 @@ void Utils::setSeed(const std::optional<size_t>& seed)
 {
     this->seed = seed.value_or(std::chrono::high_resolution_clock::now().time_since_epoch().count());
 
-    rng = std::mt19937_64(this->seed);
+    streams = 0;
 }
 
 Profiler::Profiler(const double frequency) :
@@ -0,0 +1,35 @@
+#include "../include/waveform.h"
+
+using namespace Engine;
+
+void Waveform::sine(double* values, const size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        values[i] = sine(values[i]);
+    }
+}
+
+void Waveform::square(double* values, const size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        values[i] = square(values[i]);
+    }
+}
+
+void Waveform::saw(double* values, const size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        values[i] = saw(values[i]);
+    }
+}
+
+void Waveform::triangle(double* values, const size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        values[i] = triangle(values[i]);
+    }
+}
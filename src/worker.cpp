@@ -0,0 +1,205 @@
+#include "../include/worker.h"
+
+#include "../include/object.h"
+
+using namespace Engine;
+
+WorkerPool::WorkerPool(const size_t threads) :
+    queues(std::max<size_t>(threads, 1))
+{
+    for (size_t i = 1; i < queues.size(); i++)
+    {
+        workers.emplace_back(&WorkerPool::work, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        stopping = true;
+    }
+
+    started.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void WorkerPool::run(const std::vector<double>& costs, const std::vector<std::vector<size_t>>& dependencies, const std::function<void(const size_t)>& task)
+{
+    if (successors.size() != costs.size())
+    {
+        successors = std::vector<std::vector<size_t>>(costs.size());
+        remaining = std::vector<std::atomic<size_t>>(costs.size());
+    }
+
+    std::vector<size_t> order;
+
+    for (size_t i = 0; i < costs.size(); i++)
+    {
+        successors[i].clear();
+    }
+
+    for (size_t i = 0; i < costs.size(); i++)
+    {
+        remaining[i] = dependencies[i].size();
+
+        for (const size_t dependency : dependencies[i])
+        {
+            successors[dependency].push_back(i);
+        }
+
+        if (dependencies[i].empty())
+        {
+            order.push_back(i);
+        }
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&costs](const size_t a, const size_t b)
+    {
+        return costs[a] > costs[b];
+    });
+
+    std::vector<std::pair<double, size_t>> loads(queues.size());
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        for (const size_t index : order)
+        {
+            const size_t queue = std::min_element(loads.begin(), loads.end()) - loads.begin();
+
+            queues[queue].tasks.push_back(index);
+
+            loads[queue].first += costs[index];
+            loads[queue].second++;
+        }
+
+        this->task = &task;
+
+        unfinished = costs.size();
+        pending = workers.size();
+
+        generation++;
+    }
+
+    started.notify_all();
+
+    perform(0);
+
+    std::unique_lock<std::mutex> guard(lock);
+
+    finished.wait(guard, [this] { return pending == 0; });
+}
+
+void WorkerPool::work(const size_t index)
+{
+    size_t seen = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+
+            started.wait(guard, [this, seen] { return stopping || generation != seen; });
+
+            if (stopping)
+            {
+                break;
+            }
+
+            seen = generation;
+        }
+
+        perform(index);
+
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (--pending == 0)
+        {
+            finished.notify_all();
+        }
+    }
+
+    Defaults::deinit();
+}
+
+void WorkerPool::perform(const size_t index)
+{
+    size_t next;
+
+    while (unfinished > 0)
+    {
+        if (take(index, next) || steal(index, next))
+        {
+            (*task)(next);
+
+            release(index, next);
+
+            unfinished--;
+        }
+
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void WorkerPool::release(const size_t index, const size_t task)
+{
+    for (const size_t successor : successors[task])
+    {
+        if (--remaining[successor] == 0)
+        {
+            Queue& queue = queues[index];
+
+            std::lock_guard<std::mutex> guard(queue.lock);
+
+            queue.tasks.push_front(successor);
+        }
+    }
+}
+
+bool WorkerPool::take(const size_t index, size_t& next)
+{
+    Queue& queue = queues[index];
+
+    std::lock_guard<std::mutex> guard(queue.lock);
+
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+
+    next = queue.tasks.front();
+
+    queue.tasks.pop_front();
+
+    return true;
+}
+
+bool WorkerPool::steal(const size_t index, size_t& next)
+{
+    for (size_t i = 1; i < queues.size(); i++)
+    {
+        Queue& queue = queues[(index + i) % queues.size()];
+
+        std::lock_guard<std::mutex> guard(queue.lock);
+
+        if (!queue.tasks.empty())
+        {
+            next = queue.tasks.back();
+
+            queue.tasks.pop_back();
+
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -75,6 +75,10 @@ private:
     void testMax();
     void testRound();
     void testAbsolute();
+    void testVariable();
+    void testControlRate();
+    void testBlock();
+    void testSharedBlock();
 
     void expectValues(ValueObject* object, const std::vector<TimeValue>& values, const double epsilon = std::numeric_limits<double>::epsilon());
     void expectConstant(ValueObject* object, const double value, const double epsilon = std::numeric_limits<double>::epsilon());
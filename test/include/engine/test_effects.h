@@ -0,0 +1,42 @@
+#pragma once
+
+#include <complex>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "controller.h"
+#include "effect.h"
+#include "fft.h"
+#include "object.h"
+#include "random.h"
+#include "resource.h"
+#include "snapshot.h"
+
+#include "../test.h"
+#include "../test_utils.h"
+
+using namespace Engine;
+
+struct TestEffects : public Test
+{
+    static void run(TestTracker* tracker);
+
+protected:
+    void test() override;
+
+private:
+    TestEffects(TestTracker* tracker);
+
+    void testDelayBuffer();
+    void testDelayMatrix();
+    void testBiquad();
+    void testFFT();
+    void testConvolve();
+
+    void expectBuffer(const std::vector<double>& expected, const std::vector<double>& actual, const double epsilon);
+
+    Utils* utils;
+
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "parse.h"
+#include "random.h"
+#include "resource.h"
+#include "source.h"
+#include "token.h"
+#include "transform.h"
+
+#include "../test.h"
+#include "../test_utils.h"
+
+using namespace Engine;
+
+struct TestResources : public Test
+{
+    static void run(TestTracker* tracker);
+
+protected:
+    void test() override;
+
+private:
+    TestResources(TestTracker* tracker);
+
+    void testCache();
+    void testDeduplication();
+    void testMix();
+
+    void expectSamples(const std::vector<float>& expected, const ResourceData* data);
+
+    Utils* utils;
+
+};
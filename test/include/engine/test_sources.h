@@ -0,0 +1,43 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "audiosource.h"
+#include "controller.h"
+#include "object.h"
+#include "random.h"
+#include "resource.h"
+#include "snapshot.h"
+#include "waveform.h"
+
+#include "../test.h"
+#include "../test_utils.h"
+
+using namespace Engine;
+
+struct TestSources : public Test
+{
+    static void run(TestTracker* tracker);
+
+protected:
+    void test() override;
+
+private:
+    TestSources(TestTracker* tracker);
+
+    void testWaveform();
+    void testOscillatorBank();
+    void testGrainPool();
+    void testGrainShape();
+    void testGrainSnapshot();
+
+    void expectWaveform(const std::string& name, const std::function<double(double)>& kernel, const std::function<void(double*, size_t)>& block, const std::function<double(double)>& reference, const double epsilon);
+
+    Utils* utils;
+
+};
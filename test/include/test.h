@@ -1,5 +1,8 @@
 #pragma once
 
+#include <filesystem>
+#include <optional>
+#include <sndfile.hh>
 #include <stddef.h>
 #include <string>
 #include <vector>
@@ -7,6 +10,8 @@
 #include "exception.h"
 #include "otest.h"
 #include "path.h"
+#include "resource.h"
+#include "source.h"
 #include "test_utils.h"
 #include "utils.h"
 
@@ -20,6 +25,10 @@ protected:
 
     const Path sourcePath(const std::string& file) const;
     const Path testPath(const std::string& file) const;
+    const Path tempPath(const std::string& file) const;
+
+    const Path writeAudio(const std::string& file, const std::vector<float>& samples, const unsigned int channels, const unsigned int sampleRate) const;
+    Engine::ResourceData* readAudio(const Path& path, const std::optional<Path>& cacheDirectory = std::nullopt) const;
 
     void beginSuite(const std::string& name) const;
 
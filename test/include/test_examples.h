@@ -1,13 +1,23 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <future>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
 #include "exception.h"
 #include "parse.h"
 #include "path.h"
+#include "program.h"
 #include "source.h"
 #include "test.h"
 #include "test_utils.h"
 #include "token.h"
 #include "transform.h"
+#include "utils.h"
 
 struct TestExamples : public Test
 {
@@ -20,5 +30,24 @@ private:
     TestExamples(TestTracker* tracker);
 
     void expectSuccess(const Path& path);
+    void expectBlockRender(const Path& path);
+    void expectBytecodeRender(const Path& path);
+    void expectThreadedRender(const Path& path);
+    void expectParallelRender(const Path& path);
+    void expectRestoredRender(const Path& path);
+    void expectRejectedSnapshot(const Path& path);
+    void expectSeekRender(const Path& path);
+    void expectControlRender(const Path& path);
+
+    void expectSameRender(const std::vector<double>& expected, const std::vector<double>& actual, const double epsilon = 0);
+
+    std::vector<double> render(const Path& path, const size_t blockLength, const bool bytecode, const unsigned int threads = 1, const size_t seconds = 1, const unsigned int controlPeriod = 1) const;
+    std::vector<double> renderThreaded(const Path& path, const Utils* parent) const;
+    std::vector<double> renderRestored(const Path& path) const;
+    std::vector<double> renderSeek(const Path& path, const size_t frames, const size_t target) const;
+
+    Engine::Program* compile(const Path& path, const bool bytecode, const unsigned int controlPeriod = 1) const;
+
+    const Path writeGranulate() const;
 
 };
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cmath>
 #include <limits>
+#include <string>
 
 #include "exception.h"
 #include "otest.h"
@@ -22,6 +24,7 @@ protected:
 private:
     TestValue(TestTracker* tracker);
 
-    void expectValue(const OTest* info);
+    void expectValue(const OTest* info, const bool bytecode);
+    void expectFolding(const std::string& kind, const Engine::ValueObject* object, const bool bytecode);
 
 };
@@ -0,0 +1,132 @@
+#include "engine/test_controllers.h"
+
+void TestControllers::testBlock()
+{
+    beginTest("Block", true);
+
+    const std::function<ValueObject*()> create = []()
+    {
+        return new ValueAdd(
+            new ValueMultiply(new Sweep(new Value(0), new Value(5), new Value(1000)), new Time()),
+            new ValueNegate(new Hold(new Value(2), new Value(250))));
+    };
+
+    std::unique_ptr<ValueObject> frame(create());
+    std::unique_ptr<ValueObject> block(create());
+
+    const size_t start = utils->frame + 1;
+    const size_t frames = utils->sampleRate / 2;
+    const size_t blockLength = 100;
+
+    std::vector<double> expected(frames);
+    std::vector<double> actual(frames);
+
+    size_t expectedStop = frames;
+    size_t stopped = frames;
+
+    utils->setFrame(start);
+
+    frame->start(utils->time);
+    block->start(utils->time);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        utils->setFrame(start + i);
+
+        frame->update();
+
+        expected[i] = frame->getValue();
+
+        if (expectedStop == frames && !frame->enabled)
+        {
+            expectedStop = i;
+        }
+    }
+
+    for (size_t i = 0; i < frames; i += blockLength)
+    {
+        utils->setFrame(start + i);
+
+        const size_t length = std::min(blockLength, frames - i);
+        const size_t active = block->getBlock(actual.data() + i, length);
+
+        if (stopped == frames && active < length)
+        {
+            stopped = i + active;
+        }
+    }
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        if (actual[i] != expected[i])
+        {
+            fail("Expected " + TestUtils::formatDouble(expected[i]) + " at frame " + std::to_string(i) + ", but received " + TestUtils::formatDouble(actual[i]));
+
+            break;
+        }
+    }
+
+    if (stopped != expectedStop || block->enabled || frame->getStopTime() != block->getStopTime())
+    {
+        fail("Expected block evaluation to stop at frame " + std::to_string(expectedStop) + ", but it stopped at frame " + std::to_string(stopped));
+    }
+
+    endTest();
+}
+
+void TestControllers::testSharedBlock()
+{
+    beginTest("Shared block", true);
+
+    const size_t start = utils->frame + 1;
+
+    // a shared value read twice stops partway through a block, the second
+    // reader must keep the frames before the stop as well
+
+    const size_t length = utils->sampleRate / 100 + 37;
+
+    std::unique_ptr<SharedValue> sharedFrame(new SharedValue(new Hold(new Value(0.5), new Value(1000.0 * length / utils->sampleRate))));
+    std::unique_ptr<SharedValue> sharedBlock(new SharedValue(new Hold(new Value(0.5), new Value(1000.0 * length / utils->sampleRate))));
+
+    std::unique_ptr<ValueObject> frame(new ValueAdd(new Variable(sharedFrame.get()), new Variable(sharedFrame.get())));
+    std::unique_ptr<ValueObject> block(new ValueAdd(new Variable(sharedBlock.get()), new Variable(sharedBlock.get())));
+
+    const size_t frames = length * 3;
+    const size_t blockLength = 128;
+
+    std::vector<double> expected(frames);
+    std::vector<double> actual(frames);
+
+    utils->setFrame(start);
+
+    frame->start(utils->time);
+    block->start(utils->time);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        utils->setFrame(start + i);
+
+        frame->update();
+
+        expected[i] = frame->getValue();
+    }
+
+    for (size_t i = 0; i < frames; i += blockLength)
+    {
+        utils->setFrame(start + i);
+
+        block->getBlock(actual.data() + i, std::min(blockLength, frames - i));
+    }
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        if (actual[i] != expected[i])
+        {
+            fail("Expected " + TestUtils::formatDouble(expected[i]) + " at frame " + std::to_string(i) + ", but received " + TestUtils::formatDouble(actual[i]));
+
+            break;
+        }
+    }
+
+    endTest();
+}
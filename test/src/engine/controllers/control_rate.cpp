@@ -0,0 +1,157 @@
+#include "engine/test_controllers.h"
+
+namespace {
+
+struct UpdateCounter : public ValueObject
+{
+    size_t updates = 0;
+
+protected:
+    void updateInternal() override
+    {
+        updates++;
+    }
+};
+
+}
+
+void TestControllers::testControlRate()
+{
+    beginTest("Control rate", true);
+
+    expectConstant(new ControlRate(new Value(5), 32), 5);
+
+    expectValues(new ControlRate(new Hold(new Value(5), new Value(1000)), 32),
+    {
+        TimeValue(0, 5),
+        TimeValue(500, 5),
+        TimeValue(1001, 0)
+    });
+
+    expectValues(new ControlRate(new Sweep(new Value(0), new Value(5), new Value(1000)), 32),
+    {
+        TimeValue(0, 0),
+        TimeValue(250, 1.25),
+        TimeValue(500, 2.5),
+        TimeValue(750, 3.75),
+        TimeValue(1001, 0)
+    }, 0.01);
+
+    UpdateCounter* counter = new UpdateCounter();
+
+    std::unique_ptr<ValueObject> object(new ControlRate(counter, 32));
+
+    object->start(utils->time);
+
+    for (size_t i = 0; i < 64; i++)
+    {
+        utils->frame++;
+
+        object->update();
+    }
+
+    if (counter->updates != 2)
+    {
+        fail("Expected the controller to be updated on 2 control ticks, but it was updated " + std::to_string(counter->updates) + " times.");
+    }
+
+    std::unique_ptr<ValueObject> constant(new ValueAdd(new Value(1), new Value(2)));
+    std::unique_ptr<ValueObject> control(new ValueAdd(new Value(1), new Sweep(new Value(0), new Value(5), new Value(1000))));
+    std::unique_ptr<ValueObject> audio(new ValueAdd(new Time(), new Absolute(new Hold(new Value(5), new Value(1000)))));
+
+    if (constant->getRate() != Constants::Constant || control->getRate() != Constants::Control || audio->getRate() != Constants::Audio)
+    {
+        fail("Expected controllers to be classified as constant, control and audio rate.");
+    }
+
+    std::unique_ptr<ValueObject> random(new Random(new Value(0), new Value(5), new Value(1000), new ValueChar(Constants::Random::Linear)));
+    std::unique_ptr<ValueObject> controlLimit(new Limit(new Sweep(new Value(0), new Value(5), new Value(1000)), new Value(1), new Value(4)));
+    std::unique_ptr<ValueObject> audioLimit(new Limit(new Sweep(new Value(0), new Value(5), new Value(1000)), new Absolute(new Value(1)), new Value(4)));
+
+    if (random->getRate() != Constants::Control || controlLimit->getRate() != Constants::Control || audioLimit->getRate() != Constants::Audio)
+    {
+        fail("Expected random controllers to be control rate and limits to take the fastest rate of their inputs.");
+    }
+
+    std::unique_ptr<ValueObject> controlEvents(new Repeat(new Sequence(new List({ new Hold(new Value(1), new Value(10)), new Sweep(new Value(1), new Value(0), new Value(10)) }), new ValueChar(Constants::Sequence::Forward)), new Value(0)));
+    std::unique_ptr<ValueObject> audioEvents(new Repeat(new Sequence(new List({ new Hold(new Value(1), new Value(10)), new Absolute(new Value(1)) }), new ValueChar(Constants::Sequence::Forward)), new Value(0)));
+
+    if (controlEvents->getRate() != Constants::Control || audioEvents->getRate() != Constants::Audio)
+    {
+        fail("Expected repeats, sequences and holds to take the rate of their children.");
+    }
+
+    // a repeated sweep jumps back to its start every 100 frames, the ramp has
+    // to follow the sweep within the change of one period everywhere except
+    // the period after each jump, and restart from the new value on the first
+    // tick after it
+
+    const size_t period = 32;
+    const size_t length = 100;
+    const double slope = 1.0 / length;
+
+    const std::function<ValueObject*()> create = [this]()
+    {
+        return new Repeat(new Sweep(new Value(0), new Value(1), new Value(1000.0 * length / utils->sampleRate)), new Value(0));
+    };
+
+    std::unique_ptr<ValueObject> audioRate(create());
+    std::unique_ptr<ValueObject> controlRate(new ControlRate(create(), period));
+
+    const size_t start = utils->frame + 1;
+    const size_t frames = length * 5;
+
+    utils->setFrame(start);
+
+    audioRate->start(utils->time);
+    controlRate->start(utils->time);
+
+    size_t restart = 0;
+    size_t restarts = 0;
+
+    double last = 0;
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        utils->setFrame(start + i);
+
+        audioRate->update();
+        controlRate->update();
+
+        const double expected = audioRate->getValue();
+        const double actual = controlRate->getValue();
+
+        if (expected < last)
+        {
+            restart = (i + period - 1) / period * period;
+        }
+
+        last = expected;
+
+        if (i > 0 && i == restart)
+        {
+            restarts++;
+
+            if (fabs(actual - expected) > 1e-9)
+            {
+                fail("Expected the ramp to restart at " + TestUtils::formatDouble(expected) + " on frame " + std::to_string(i) + ", but received " + TestUtils::formatDouble(actual));
+
+                break;
+            }
+        }
+
+        if (i % length >= period && fabs(actual - expected) > slope * period)
+        {
+            fail("Expected the ramp to stay within " + TestUtils::formatDouble(slope * period) + " of " + TestUtils::formatDouble(expected) + " on frame " + std::to_string(i) + ", but received " + TestUtils::formatDouble(actual));
+
+            break;
+        }
+    }
+
+    if (restarts != 4)
+    {
+        fail("Expected the ramp to restart after 4 repeats, but it restarted " + std::to_string(restarts) + " times.");
+    }
+
+    endTest();
+}
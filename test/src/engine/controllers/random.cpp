@@ -11,41 +11,41 @@ void TestControllers::testRandom()
 
     expectValues(new Random(new Value(0), new Value(5), new Value(1000), new ValueChar(Constants::Random::Step)),
     {
-        TimeValue(0, 0.798967),
-        TimeValue(250, 0.798967),
-        TimeValue(500, 0.798967),
-        TimeValue(750, 0.798967),
+        TimeValue(0, 4.402601),
+        TimeValue(250, 4.402601),
+        TimeValue(500, 4.402601),
+        TimeValue(750, 4.402601),
         TimeValue(1000, 0)
     }, 1e-6);
 
     expectValues(new Random(new Value(5), new Value(0), new Value(1000), new ValueChar(Constants::Random::Step)),
     {
-        TimeValue(0, 4.201033),
-        TimeValue(250, 4.201033),
-        TimeValue(500, 4.201033),
-        TimeValue(750, 4.201033),
+        TimeValue(0, 0.597399),
+        TimeValue(250, 0.597399),
+        TimeValue(500, 0.597399),
+        TimeValue(750, 0.597399),
         TimeValue(1000, 0)
     }, 1e-6);
 
     expectValues(new Random(new Value(0), new Value(-5), new Value(1000), new ValueChar(Constants::Random::Step)),
     {
-        TimeValue(0, -0.798967),
-        TimeValue(250, -0.798967),
-        TimeValue(500, -0.798967),
-        TimeValue(750, -0.798967),
+        TimeValue(0, -4.402601),
+        TimeValue(250, -4.402601),
+        TimeValue(500, -4.402601),
+        TimeValue(750, -4.402601),
         TimeValue(1000, 0)
     }, 1e-6);
 
     expectValues(new Repeat(new Random(new Value(0), new Value(5), new Value(1000), new ValueChar(Constants::Random::Step)), new Value(2)),
     {
-        TimeValue(0, 0.798967),
-        TimeValue(250, 0.798967),
-        TimeValue(500, 0.798967),
-        TimeValue(750, 0.798967),
-        TimeValue(1000, 4.960726),
-        TimeValue(1250, 4.960726),
-        TimeValue(1500, 4.960726),
-        TimeValue(1750, 4.960726),
+        TimeValue(0, 4.402601),
+        TimeValue(250, 4.402601),
+        TimeValue(500, 4.402601),
+        TimeValue(750, 4.402601),
+        TimeValue(1000, 3.027409),
+        TimeValue(1250, 3.027409),
+        TimeValue(1500, 3.027409),
+        TimeValue(1750, 3.027409),
         TimeValue(2000, 0)
     }, 1e-6);
 
@@ -56,41 +56,41 @@ void TestControllers::testRandom()
 
     expectValues(new Random(new Value(0), new Value(5), new Value(1000), new ValueChar(Constants::Random::Linear)),
     {
-        TimeValue(0, 0.798967),
-        TimeValue(250, 1.839407),
-        TimeValue(500, 2.879846),
-        TimeValue(750, 3.920286),
+        TimeValue(0, 4.402601),
+        TimeValue(250, 4.058803),
+        TimeValue(500, 3.715005),
+        TimeValue(750, 3.371207),
         TimeValue(1000, 0)
     }, 1e-6);
 
     expectValues(new Random(new Value(5), new Value(0), new Value(1000), new ValueChar(Constants::Random::Linear)),
     {
-        TimeValue(0, 4.201033),
-        TimeValue(250, 3.160593),
-        TimeValue(500, 2.120154),
-        TimeValue(750, 1.079714),
+        TimeValue(0, 0.597399),
+        TimeValue(250, 0.941197),
+        TimeValue(500, 1.284995),
+        TimeValue(750, 1.628793),
         TimeValue(1000, 0)
     }, 1e-6);
 
     expectValues(new Random(new Value(0), new Value(-5), new Value(1000), new ValueChar(Constants::Random::Linear)),
     {
-        TimeValue(0, -0.798967),
-        TimeValue(250, -1.839407),
-        TimeValue(500, -2.879846),
-        TimeValue(750, -3.920286),
+        TimeValue(0, -4.402601),
+        TimeValue(250, -4.058803),
+        TimeValue(500, -3.715005),
+        TimeValue(750, -3.371207),
         TimeValue(1000, 0)
     }, 1e-6);
 
     expectValues(new Repeat(new Random(new Value(0), new Value(5), new Value(1000), new ValueChar(Constants::Random::Linear)), new Value(2)),
     {
-        TimeValue(0, 0.798967),
-        TimeValue(250, 1.839407),
-        TimeValue(500, 2.879846),
-        TimeValue(750, 3.920286),
-        TimeValue(1000, 4.960726),
-        TimeValue(1250, 3.770006),
-        TimeValue(1500, 2.579286),
-        TimeValue(1750, 1.388565),
+        TimeValue(0, 4.402601),
+        TimeValue(250, 4.058803),
+        TimeValue(500, 3.715005),
+        TimeValue(750, 3.371207),
+        TimeValue(1000, 3.027409),
+        TimeValue(1250, 2.723171),
+        TimeValue(1500, 2.418932),
+        TimeValue(1750, 2.114694),
         TimeValue(2000, 0)
     }, 1e-6);
 
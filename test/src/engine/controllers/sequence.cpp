@@ -48,12 +48,12 @@ void TestControllers::testSequence()
         new Hold(new Value(7), new Value(1000))
     }), new ValueChar(Constants::Sequence::Shuffle)),
     {
-        TimeValue(0, 5),
-        TimeValue(1, 5),
-        TimeValue(1000, 7),
-        TimeValue(1001, 7),
-        TimeValue(2000, 6),
-        TimeValue(2001, 6),
+        TimeValue(0, 7),
+        TimeValue(1, 7),
+        TimeValue(1000, 6),
+        TimeValue(1001, 6),
+        TimeValue(2000, 5),
+        TimeValue(2001, 5),
         TimeValue(3000, 0)
     });
 
@@ -104,12 +104,12 @@ void TestControllers::testSequence()
         new Hold(new ValueChar(7), new Value(1000))
     }), new ValueChar(Constants::Sequence::Shuffle)),
     {
-        TimeLambda(0, compareChar(5)),
-        TimeLambda(1, compareChar(5)),
-        TimeLambda(1000, compareChar(7)),
-        TimeLambda(1001, compareChar(7)),
-        TimeLambda(2000, compareChar(6)),
-        TimeLambda(2001, compareChar(6)),
+        TimeLambda(0, compareChar(7)),
+        TimeLambda(1, compareChar(7)),
+        TimeLambda(1000, compareChar(6)),
+        TimeLambda(1001, compareChar(6)),
+        TimeLambda(2000, compareChar(5)),
+        TimeLambda(2001, compareChar(5)),
         TimeLambda(3000, compareChar(0))
     });
 
@@ -160,12 +160,12 @@ void TestControllers::testSequence()
         new Hold(new List({ new Value(7) }), new Value(1000))
     }), new ValueChar(Constants::Sequence::Shuffle)),
     {
-        TimeLambda(0, compareList({ 5 })),
-        TimeLambda(1, compareList({ 5 })),
-        TimeLambda(1000, compareList({ 7 })),
-        TimeLambda(1001, compareList({ 7 })),
-        TimeLambda(2000, compareList({ 6 })),
-        TimeLambda(2001, compareList({ 6 })),
+        TimeLambda(0, compareList({ 7 })),
+        TimeLambda(1, compareList({ 7 })),
+        TimeLambda(1000, compareList({ 6 })),
+        TimeLambda(1001, compareList({ 6 })),
+        TimeLambda(2000, compareList({ 5 })),
+        TimeLambda(2001, compareList({ 5 })),
         TimeLambda(3000, compareList({}))
     });
 
@@ -0,0 +1,40 @@
+#include "engine/test_controllers.h"
+
+void TestControllers::testVariable()
+{
+    beginTest("Variable", true);
+
+    std::unique_ptr<SharedValue> sweep(new SharedValue(new Sweep(new Value(0), new Value(5), new Value(1000))));
+
+    expectValues(new ValueAdd(new Variable(sweep.get()), new Variable(sweep.get())),
+    {
+        TimeValue(0, 0),
+        TimeValue(250, 2.5),
+        TimeValue(500, 5),
+        TimeValue(750, 7.5),
+        TimeValue(1000, 0)
+    });
+
+    std::unique_ptr<SharedValue> repeat(new SharedValue(new Repeat(new Hold(new Value(1), new Value(0)), new Value(3))));
+    std::unique_ptr<ValueObject> object(new ValueAdd(new Variable(repeat.get()), new Variable(repeat.get())));
+
+    utils->time = 0;
+
+    object->start(0);
+
+    for (size_t i = 1; i <= 3; i++)
+    {
+        utils->frame++;
+
+        object->update();
+
+        if (object->enabled != (i < 3))
+        {
+            fail("Expected shared variable to stop after 3 updates, but it stopped after " + std::to_string(i) + ".");
+
+            break;
+        }
+    }
+
+    endTest();
+}
@@ -0,0 +1,103 @@
+#include "engine/test_effects.h"
+
+void TestEffects::testBiquad()
+{
+    beginTest("Biquad", true);
+
+    // LowPass computed its coefficients inline for every frame before it
+    // moved onto Biquad, this replays that filter as the reference
+
+    const size_t frames = 4000;
+
+    std::vector<double> raw(utils->channels * 2, 0);
+    std::vector<double> filtered(utils->channels * 2, 0);
+
+    std::vector<double> expected;
+    std::vector<double> actual;
+
+    Biquad lowPass(utils->channels);
+
+    RandomStream random;
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        const double threshold = i < 1000 ? 800 : i < 3000 ? 800 + i * 3 : 250;
+
+        const double omega = tan(utils->pi * threshold / utils->sampleRate);
+        const double omega2 = omega * omega;
+        const double c = 1 + sqrt(2) * omega + omega2;
+        const double a = omega2 / c;
+        const double b1 = 2 * (omega2 - 1) / c;
+        const double b2 = (1 - sqrt(2) * omega + omega2) / c;
+
+        std::vector<double> buffer(utils->channels);
+
+        for (size_t j = 0; j < utils->channels; j++)
+        {
+            buffer[j] = random.uniform(-1, 1);
+        }
+
+        std::vector<double> values = buffer;
+
+        for (size_t j = 0; j < utils->channels; j++)
+        {
+            const double value = buffer[j];
+
+            buffer[j] = a * (buffer[j] + raw[j] * 2 + raw[j + utils->channels]) - b1 * filtered[j] - b2 * filtered[j + utils->channels];
+
+            raw[j + utils->channels] = raw[j];
+            raw[j] = value;
+
+            filtered[j + utils->channels] = filtered[j];
+            filtered[j] = buffer[j];
+        }
+
+        lowPass.setLowPass(threshold);
+        lowPass.apply(values.data());
+
+        expected.insert(expected.end(), buffer.begin(), buffer.end());
+        actual.insert(actual.end(), values.begin(), values.end());
+    }
+
+    expectBuffer(expected, actual, 1e-12);
+
+    // steady state gains: a constant input and a sine at the band centre
+
+    Biquad highPass(1);
+    Biquad bandPass(2);
+
+    double high = 0;
+    double band[2] = { 0 };
+    double peak = 0;
+
+    for (size_t i = 0; i < utils->sampleRate; i++)
+    {
+        high = 1;
+
+        band[0] = 1;
+        band[1] = sin(utils->twoPi * 1000 * i / utils->sampleRate);
+
+        highPass.setHighPass(1000);
+        highPass.apply(&high);
+
+        bandPass.setBandPass(1000, 2);
+        bandPass.apply(band);
+
+        if (i >= utils->sampleRate - 1000)
+        {
+            peak = std::max(peak, fabs(band[1]));
+        }
+    }
+
+    if (fabs(high) > 1e-9)
+    {
+        fail("Expected a high pass filter to remove a constant input, but received " + TestUtils::formatDouble(high));
+    }
+
+    if (fabs(band[0]) > 1e-9 || fabs(peak - 1) > 1e-3)
+    {
+        fail("Expected a band pass filter to remove a constant input and pass its centre frequency, but received " + TestUtils::formatDouble(band[0]) + " and a peak of " + TestUtils::formatDouble(peak));
+    }
+
+    endTest();
+}
@@ -0,0 +1,126 @@
+#include "engine/test_effects.h"
+
+void TestEffects::testFFT()
+{
+    beginTest("FFT", true);
+
+    const size_t size = 1024;
+
+    FFT fft(size);
+
+    RandomStream random;
+
+    std::vector<std::complex<double>> values(size);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        values[i] = std::complex<double>(random.uniform(-1, 1), random.uniform(-1, 1));
+    }
+
+    std::vector<std::complex<double>> transformed = values;
+
+    fft.forward(transformed.data());
+
+    // compare a few bins against a direct DFT before transforming back
+
+    for (const size_t bin : { 0, 1, 7, 511, 512, 1023 })
+    {
+        std::complex<double> expected = 0;
+
+        for (size_t i = 0; i < size; i++)
+        {
+            expected += values[i] * std::polar(1.0, -2 * M_PI * bin * i / size);
+        }
+
+        if (std::abs(transformed[bin] - expected) > 1e-9)
+        {
+            fail("Expected bin " + std::to_string(bin) + " to match a direct transform, but it differed by " + TestUtils::formatDouble(std::abs(transformed[bin] - expected)));
+        }
+    }
+
+    fft.inverse(transformed.data());
+
+    for (size_t i = 0; i < size; i++)
+    {
+        if (std::abs(transformed[i] - values[i]) > 1e-12)
+        {
+            fail("Expected the inverse transform to restore index " + std::to_string(i) + ", but it differed by " + TestUtils::formatDouble(std::abs(transformed[i] - values[i])));
+
+            break;
+        }
+    }
+
+    endTest();
+}
+
+void TestEffects::testConvolve()
+{
+    beginTest("Convolve", true);
+
+    // the first partition is applied directly, so with an impulse shorter
+    // than a partition and one spanning three, the wet signal is the direct
+    // convolution with no latency and lines up with the dry signal
+
+    const double mix = 0.5;
+    const size_t frames = 6000;
+
+    for (const size_t length : { 300, 1300 })
+    {
+        RandomStream random;
+
+        std::vector<float> impulse(length * utils->channels);
+
+        for (float& sample : impulse)
+        {
+            sample = random.uniform(-1, 1) * 0.1;
+        }
+
+        const Path path = writeAudio("impulse.wav", impulse, utils->channels, utils->sampleRate);
+
+        std::unique_ptr<Convolve> convolve(new Convolve(new Value(mix), new Resource(SharedResourceData(readAudio(path)))));
+
+        std::vector<double> input(frames * utils->channels);
+
+        for (double& sample : input)
+        {
+            sample = random.uniform(-1, 1);
+        }
+
+        std::vector<double> expected(frames * utils->channels, 0);
+        std::vector<double> actual = input;
+
+        for (size_t i = 0; i < frames; i++)
+        {
+            for (size_t j = 0; j < utils->channels; j++)
+            {
+                double wet = 0;
+
+                for (size_t k = 0; k < length && k <= i; k++)
+                {
+                    wet += impulse[k * utils->channels + j] * input[(i - k) * utils->channels + j];
+                }
+
+                expected[i * utils->channels + j] = input[i * utils->channels + j] * (1 - mix) + wet * mix;
+            }
+        }
+
+        const size_t start = utils->frame + 1;
+
+        utils->setFrame(start);
+
+        convolve->start(utils->time);
+
+        for (size_t i = 0; i < frames; i += utils->bufferLength)
+        {
+            utils->setFrame(start + i);
+
+            convolve->applyBlock(actual.data() + i * utils->channels, std::min<size_t>(utils->bufferLength, frames - i));
+        }
+
+        expectBuffer(expected, actual, 1e-9);
+
+        std::filesystem::remove(path.string());
+    }
+
+    endTest();
+}
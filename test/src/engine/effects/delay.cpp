@@ -0,0 +1,144 @@
+#include "engine/test_effects.h"
+
+void TestEffects::testDelayBuffer()
+{
+    beginTest("Delay buffer", true);
+
+    // frame k holds k on the first channel and k + 1000 on the second, so a
+    // read at delay d from position p expects p - d
+
+    const size_t frames = 200;
+    const std::vector<double> delays = {1, 2, 10, 3.25, 7.5, 99.875};
+
+    DelayBuffer buffer(100);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        for (size_t j = 0; j < utils->channels; j++)
+        {
+            buffer.write(j, i + j * 1000.0);
+        }
+
+        buffer.advance();
+    }
+
+    std::vector<double> expected;
+    std::vector<double> actual;
+
+    for (const double delay : delays)
+    {
+        for (size_t j = 0; j < utils->channels; j++)
+        {
+            expected.push_back(frames - delay + j * 1000.0);
+            actual.push_back(buffer.read(delay, j));
+        }
+    }
+
+    expectBuffer(expected, actual, 1e-12);
+
+    if (buffer.read(1e9, 0) != buffer.read(100, 0))
+    {
+        fail("Expected a delay beyond the limit to read the oldest frame, but received " + TestUtils::formatDouble(buffer.read(1e9, 0)));
+    }
+
+    Snapshot save;
+
+    buffer.serialize(save);
+
+    DelayBuffer restored(100);
+
+    Snapshot restore(save.getData());
+
+    restored.serialize(restore);
+    restore.finish();
+
+    actual.clear();
+
+    for (const double delay : delays)
+    {
+        for (size_t j = 0; j < utils->channels; j++)
+        {
+            actual.push_back(restored.read(delay, j));
+        }
+    }
+
+    expectBuffer(expected, actual, 1e-12);
+
+    for (size_t j = 0; j < utils->channels; j++)
+    {
+        buffer.write(j, -1);
+        restored.write(j, -1);
+    }
+
+    buffer.advance();
+    restored.advance();
+
+    if (buffer.read(1, 0) != restored.read(1, 0) || buffer.read(5.5, 1) != restored.read(5.5, 1))
+    {
+        fail("Expected a restored delay buffer to continue from the saved position.");
+    }
+
+    DelayBuffer smaller(10);
+
+    try
+    {
+        Snapshot mismatched(save.getData());
+
+        smaller.serialize(mismatched);
+
+        fail("Expected restoring a delay buffer with a different capacity to fail.");
+    }
+
+    catch (const OrganicFileException& e) {}
+
+    // only the 102 frames a read can reach are saved, rather than the whole
+    // capacity or everything written so far
+
+    const size_t header = sizeof(uint32_t) * 2 + sizeof(size_t) * 2;
+    const size_t saved = save.getData().size() - header;
+
+    if (saved != sizeof(double) * 102 * utils->channels)
+    {
+        fail("Expected the delay buffer to save 102 frames, but it saved " + std::to_string(saved / sizeof(double) / utils->channels));
+    }
+
+    const std::unique_ptr<ValueObject> bounded(new ValueAdd(new LFO(new Value(5), new Value(20), new Value(100)), new Repeat(new Sequence(new List({ new Value(30), new Sweep(new Value(10), new Value(45), new Value(10)) }), new ValueChar(Constants::Sequence::Forward)), new Value(0))));
+    const std::unique_ptr<ValueObject> unbounded(new ValueMultiply(new Sweep(new Value(10), new Value(100), new Value(1000)), new Value(2)));
+
+    if (bounded->getMaximum() != 65 || !std::isinf(unbounded->getMaximum()))
+    {
+        fail("Expected maximums of 65 and infinity, but received " + TestUtils::formatDouble(bounded->getMaximum()) + " and " + TestUtils::formatDouble(unbounded->getMaximum()));
+    }
+
+    // a modulated delay only holds the frames its longest delay can reach,
+    // so a second of input saves far less than a second of frames
+
+    std::unique_ptr<Delay> modulated(new Delay(new Value(1), new Sweep(new Value(10), new Value(100), new Value(1000)), new Value(0.5)));
+
+    modulated->start(0);
+
+    std::vector<double> frame(utils->channels);
+
+    for (size_t i = 0; i < utils->sampleRate; i++)
+    {
+        utils->setFrame(i);
+
+        std::fill(frame.begin(), frame.end(), 1.0);
+
+        modulated->update();
+        modulated->apply(frame.data());
+    }
+
+    utils->setFrame(0);
+
+    Snapshot modulatedSave;
+
+    modulated->serialize(modulatedSave);
+
+    if (modulatedSave.getData().size() > sizeof(double) * (utils->sampleRate / 10 + 1024) * utils->channels)
+    {
+        fail("Expected a modulated delay to save about 100 ms of frames, but it saved " + std::to_string(modulatedSave.getData().size()) + " bytes");
+    }
+
+    endTest();
+}
@@ -0,0 +1,64 @@
+#include "engine/test_effects.h"
+
+void TestEffects::testDelayMatrix()
+{
+    beginTest("Delay matrix", true);
+
+    // the coefficient table DelayMatrix used before the transform was
+    // factored into two Householder passes
+
+    const double coeffs[256] =
+    {
+        1, -1, -1, -1, -1, 1, 1, 1, -1, 1, 1, 1, -1, 1, 1, 1,
+        -1, 1, -1, -1, 1, -1, 1, 1, 1, -1, 1, 1, 1, -1, 1, 1,
+        -1, -1, 1, -1, 1, 1, -1, 1, 1, 1, -1, 1, 1, 1, -1, 1,
+        -1, -1, -1, 1, 1, 1, 1, -1, 1, 1, 1, -1, 1, 1, 1, -1,
+        -1, 1, 1, 1, 1, -1, -1, -1, -1, 1, 1, 1, -1, 1, 1, 1,
+        1, -1, 1, 1, -1, 1, -1, -1, 1, -1, 1, 1, 1, -1, 1, 1,
+        1, 1, -1, 1, -1, -1, 1, -1, 1, 1, -1, 1, 1, 1, -1, 1,
+        1, 1, 1, -1, -1, -1, -1, 1, 1, 1, 1, -1, 1, 1, 1, -1,
+        -1, 1, 1, 1, -1, 1, 1, 1, 1, -1, -1, -1, -1, 1, 1, 1,
+        1, -1, 1, 1, 1, -1, 1, 1, -1, 1, -1, -1, 1, -1, 1, 1,
+        1, 1, -1, 1, 1, 1, -1, 1, -1, -1, 1, -1, 1, 1, -1, 1,
+        1, 1, 1, -1, 1, 1, 1, -1, -1, -1, -1, 1, 1, 1, 1, -1,
+        -1, 1, 1, 1, -1, 1, 1, 1, -1, 1, 1, 1, 1, -1, -1, -1,
+        1, -1, 1, 1, 1, -1, 1, 1, 1, -1, 1, 1, -1, 1, -1, -1,
+        1, 1, -1, 1, 1, 1, -1, 1, 1, 1, -1, 1, -1, -1, 1, -1,
+        1, 1, 1, -1, 1, 1, 1, -1, 1, 1, 1, -1, -1, -1, -1, 1
+    };
+
+    RandomStream random;
+
+    std::vector<double> expected;
+    std::vector<double> actual;
+
+    for (size_t i = 0; i < 64; i++)
+    {
+        double values[16];
+
+        for (size_t j = 0; j < 16; j++)
+        {
+            values[j] = random.uniform(-1, 1);
+        }
+
+        for (size_t j = 0; j < 16; j++)
+        {
+            double mult = 0;
+
+            for (size_t k = 0; k < 16; k++)
+            {
+                mult += values[k] * coeffs[j * 16 + k] * 0.25;
+            }
+
+            expected.push_back(mult);
+        }
+
+        DelayMatrix::transform(values);
+
+        actual.insert(actual.end(), values, values + 16);
+    }
+
+    expectBuffer(expected, actual, 1e-12);
+
+    endTest();
+}
@@ -0,0 +1,110 @@
+#include "engine/test_resources.h"
+
+void TestResources::testCache()
+{
+    beginTest("Cache", true);
+
+    const size_t frames = 1000;
+
+    const Path directory = tempPath("cache");
+
+    std::filesystem::remove_all(directory.string());
+    std::filesystem::create_directories(directory.string());
+
+    RandomStream random;
+
+    std::vector<float> original(frames * utils->channels);
+    std::vector<float> modified(frames * utils->channels);
+
+    for (size_t i = 0; i < original.size(); i++)
+    {
+        original[i] = random.uniform(-1, 1);
+        modified[i] = random.uniform(-1, 1);
+    }
+
+    // resources are planar, the audio files are interleaved
+
+    const auto planar = [this](const std::vector<float>& interleaved)
+    {
+        const size_t length = interleaved.size() / utils->channels;
+
+        std::vector<float> result(interleaved.size());
+
+        for (size_t i = 0; i < length; i++)
+        {
+            for (size_t j = 0; j < utils->channels; j++)
+            {
+                result[j * length + i] = interleaved[i * utils->channels + j];
+            }
+        }
+
+        return result;
+    };
+
+    const Path path = writeAudio("cached.wav", original, utils->channels, utils->sampleRate);
+
+    std::unique_ptr<ResourceData> decoded(readAudio(path, directory));
+
+    expectSamples(planar(original), decoded.get());
+
+    size_t files = 0;
+
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory.string()))
+    {
+        if (entry.path().extension() != ".cache")
+        {
+            fail("Unexpected file \"" + entry.path().filename().string() + "\" in the cache directory");
+        }
+
+        files++;
+    }
+
+    if (files != 1)
+    {
+        fail("Expected one cache file, but found " + std::to_string(files));
+    }
+
+    std::unique_ptr<ResourceData> cached(readAudio(path, directory));
+
+    expectSamples(planar(original), cached.get());
+
+    // rewriting a short audio file without changing its size or modification
+    // time is caught by the content digest, which covers all of it
+
+    const std::filesystem::file_time_type time = std::filesystem::last_write_time(path.string());
+
+    writeAudio("cached.wav", modified, utils->channels, utils->sampleRate);
+
+    std::filesystem::last_write_time(path.string(), time);
+
+    std::unique_ptr<ResourceData> rewritten(readAudio(path, directory));
+
+    expectSamples(planar(modified), rewritten.get());
+
+    // a newer modification time makes the cache entry stale
+
+    writeAudio("cached.wav", original, utils->channels, utils->sampleRate);
+
+    std::filesystem::last_write_time(path.string(), time + std::chrono::seconds(1));
+
+    std::unique_ptr<ResourceData> stale(readAudio(path, directory));
+
+    expectSamples(planar(original), stale.get());
+
+    // a different size makes it stale as well, even with the same time
+
+    const std::vector<float> shortened(original.begin(), original.begin() + original.size() / 2);
+
+    writeAudio("cached.wav", shortened, utils->channels, utils->sampleRate);
+
+    std::filesystem::last_write_time(path.string(), time);
+
+    std::unique_ptr<ResourceData> resized(readAudio(path, directory));
+
+    expectSamples(planar(shortened), resized.get());
+
+    std::filesystem::remove(path.string());
+    std::filesystem::remove_all(directory.string());
+
+    endTest();
+}
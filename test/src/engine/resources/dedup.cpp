@@ -0,0 +1,50 @@
+#include "engine/test_resources.h"
+
+void TestResources::testDeduplication()
+{
+    beginTest("Deduplication", true);
+
+    // the audio file is removed after the first instruction loads it, so
+    // the other references to it only succeed if the decoded data is shared
+
+    const Path path = writeAudio("dedup.wav", std::vector<float>(100 * utils->channels, 0.5), utils->channels, utils->sampleRate);
+
+    const NamedSourceProvider* source = new NamedSourceProvider(tempPath("dedup.organic"), "sample(file: \"dedup.wav\")\nsample(file: \" ./dedup.wav \")\nsample(file: \"missing.wav\")");
+
+    const Parser::Program* program = nullptr;
+
+    TokenTransformer* transformer = new TokenTransformer(source->path());
+
+    try
+    {
+        program = Parser::Parser::parseSource(source);
+
+        program->resolveTypes();
+
+        delete program->instructions[0]->transform(transformer);
+
+        std::filesystem::remove(path.string());
+
+        delete program->instructions[1]->transform(transformer);
+
+        try
+        {
+            delete program->instructions[2]->transform(transformer);
+
+            fail("Expected a missing audio file to be reported.");
+        }
+
+        catch (const OrganicParseException& e) {}
+    }
+
+    catch (const OrganicException& e)
+    {
+        failWithError(e);
+    }
+
+    delete transformer;
+    delete program;
+    delete source;
+
+    endTest();
+}
@@ -0,0 +1,80 @@
+#include "engine/test_resources.h"
+
+void TestResources::testMix()
+{
+    beginTest("Mix", true);
+
+    const size_t frames = 500;
+
+    const unsigned int channels = utils->channels;
+
+    RandomStream random;
+
+    std::vector<float> mono(frames);
+    std::vector<float> stereo(frames * 2);
+    std::vector<float> quad(frames * 4);
+
+    for (float& sample : mono)
+    {
+        sample = random.uniform(-1, 1);
+    }
+
+    for (float& sample : stereo)
+    {
+        sample = random.uniform(-1, 1);
+    }
+
+    for (float& sample : quad)
+    {
+        sample = random.uniform(-1, 1);
+    }
+
+    // mono files are spread evenly over all output channels
+
+    std::vector<float> expected(frames * 2);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        expected[i] = mono[i] / 2;
+        expected[frames + i] = mono[i] / 2;
+    }
+
+    utils->channels = 2;
+
+    std::unique_ptr<ResourceData> upmixed(readAudio(writeAudio("mono.wav", mono, 1, utils->sampleRate)));
+
+    expectSamples(expected, upmixed.get());
+
+    // other input channels wrap around the output channels
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        expected[i] = quad[i * 4] + quad[i * 4 + 2];
+        expected[frames + i] = quad[i * 4 + 1] + quad[i * 4 + 3];
+    }
+
+    std::unique_ptr<ResourceData> quadMixed(readAudio(writeAudio("quad.wav", quad, 4, utils->sampleRate)));
+
+    expectSamples(expected, quadMixed.get());
+
+    expected.resize(frames);
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        expected[i] = stereo[i * 2] + stereo[i * 2 + 1];
+    }
+
+    utils->channels = 1;
+
+    std::unique_ptr<ResourceData> downmixed(readAudio(writeAudio("stereo.wav", stereo, 2, utils->sampleRate)));
+
+    expectSamples(expected, downmixed.get());
+
+    utils->channels = channels;
+
+    std::filesystem::remove(tempPath("mono.wav").string());
+    std::filesystem::remove(tempPath("quad.wav").string());
+    std::filesystem::remove(tempPath("stereo.wav").string());
+
+    endTest();
+}
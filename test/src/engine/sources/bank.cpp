@@ -0,0 +1,89 @@
+#include "engine/test_sources.h"
+
+void TestSources::testOscillatorBank()
+{
+    beginTest("Oscillator bank", true);
+
+    const std::function<std::vector<Oscillator*>()> create = []()
+    {
+        return std::vector<Oscillator*>
+        {
+            new Sine(new Value(0.5), new Value(0), new List({ new Effect() }), new Sweep(new Value(110), new Value(440), new Value(500))),
+            new Triangle(new Value(0.25), new Value(-0.5), new List({ new Effect() }), new Value(220)),
+            new Sine(new Sweep(new Value(0), new Value(1), new Value(250)), new Value(0.75), new List({ new Effect() }), new Value(-330)),
+            new Square(new Value(0.1), new Value(1), new List({ new Effect() }), new Value(55)),
+            new Saw(new Value(0.2), new Value(-1), new List({ new Effect() }), new Sweep(new Value(0), new Value(60000), new Value(1000))),
+            new Triangle(new Value(0.3), new Value(0.25), new List({ new Effect() }), new Value(0))
+        };
+    };
+
+    std::vector<Oscillator*> separate = create();
+    std::vector<Oscillator*> banked = create();
+
+    std::vector<std::unique_ptr<Oscillator>> owned;
+
+    for (size_t i = 0; i < separate.size(); i++)
+    {
+        owned.emplace_back(separate[i]);
+        owned.emplace_back(banked[i]);
+    }
+
+    // rows of the same group are summed into one buffer, every group gets
+    // its own
+
+    const std::vector<size_t> groups = { 0, 0, 1, 2, 2, 3 };
+    const size_t count = groups.back() + 1;
+
+    OscillatorBank bank(banked, std::vector<Utils*>(banked.size(), utils), groups);
+
+    const size_t start = utils->frame + 1;
+    const size_t frames = utils->sampleRate / 2;
+    const size_t blockLength = utils->bufferLength;
+    const size_t stride = blockLength * utils->channels;
+
+    std::vector<double> expected(stride * count);
+    std::vector<double> actual(stride * count);
+
+    utils->setFrame(start);
+
+    for (size_t i = 0; i < separate.size(); i++)
+    {
+        separate[i]->start(utils->time);
+        banked[i]->start(utils->time);
+    }
+
+    bool failed = false;
+
+    for (size_t i = 0; i < frames && !failed; i += blockLength)
+    {
+        const size_t length = std::min(blockLength, frames - i);
+
+        utils->setFrame(start + i);
+
+        std::fill(expected.begin(), expected.end(), 0);
+
+        for (size_t j = 0; j < separate.size(); j++)
+        {
+            separate[j]->fillBlock(expected.data() + groups[j] * stride, length);
+        }
+
+        bank.renderBlock(actual.data(), stride, start + i, length);
+
+        for (size_t j = 0; j < count && !failed; j++)
+        {
+            for (size_t k = 0; k < length * utils->channels; k++)
+            {
+                if (actual[j * stride + k] != expected[j * stride + k])
+                {
+                    fail("Expected " + TestUtils::formatDouble(expected[j * stride + k]) + " in group " + std::to_string(j) + " at frame " + std::to_string(i + k / utils->channels) + ", but received " + TestUtils::formatDouble(actual[j * stride + k]));
+
+                    failed = true;
+
+                    break;
+                }
+            }
+        }
+    }
+
+    endTest();
+}
@@ -0,0 +1,312 @@
+#include "engine/test_sources.h"
+
+struct GrainShape : public ValueObject
+{
+    GrainShape(const ShapeCoordinator* coordinator) :
+        coordinator(coordinator) {}
+
+    double getValue() const override
+    {
+        const double progress = coordinator->getValue();
+
+        return progress * (1 - progress) * 4;
+    }
+
+private:
+    const ShapeCoordinator* coordinator;
+
+};
+
+void TestSources::testGrainPool()
+{
+    beginTest("Grain pool", true);
+
+    const size_t capacity = 8;
+
+    RandomStream samples;
+
+    std::vector<float> audio(2000 * utils->channels);
+
+    for (float& sample : audio)
+    {
+        sample = samples.uniform(-1, 1);
+    }
+
+    const Path path = writeAudio("grains.wav", audio, utils->channels, utils->sampleRate);
+
+    const std::unique_ptr<Resource> resource(new Resource(SharedResourceData(readAudio(path))));
+
+    ShapeCoordinator coordinator;
+    GrainShape shape(&coordinator);
+
+    RandomStream random(1, 2);
+
+    GrainPool pool(&random);
+
+    pool.reserve(capacity);
+
+    while (pool.getActiveLength() < capacity)
+    {
+        if (!pool.spawn(resource.get(), 700))
+        {
+            fail("Expected the pool to have room for " + std::to_string(capacity) + " grains, but it only held " + std::to_string(pool.getTotalLength()));
+
+            break;
+        }
+    }
+
+    if (pool.spawn(resource.get(), 700) || pool.getTotalLength() != capacity)
+    {
+        fail("Expected a full pool to refuse new grains.");
+    }
+
+    std::vector<double> frame(utils->channels);
+
+    bool failed = false;
+    bool silent = true;
+
+    for (size_t i = 0; i < 6000 && !failed; i++)
+    {
+        // grains are recycled in place while the count holds, finish without
+        // respawning when it drops, and only refill the free slots once it
+        // rises again
+
+        const size_t grains = i < 2000 ? capacity : i < 4000 ? 3 : 12;
+        const size_t length = i < 1500 ? 700 : i < 3500 ? 300 : 2500;
+
+        while (pool.getActiveLength() < grains)
+        {
+            if (!pool.spawn(resource.get(), length))
+            {
+                break;
+            }
+        }
+
+        std::fill(frame.begin(), frame.end(), 0);
+
+        pool.apply(frame.data(), resource.get(), &shape, &coordinator, length, grains);
+
+        for (const double value : frame)
+        {
+            silent &= value == 0;
+        }
+
+        const size_t total = pool.getTotalLength();
+        const size_t active = pool.getActiveLength();
+
+        if (total > capacity || active > std::min(grains, capacity) || active > total)
+        {
+            fail("Expected at most " + std::to_string(std::min(grains, capacity)) + " active grains within a capacity of " + std::to_string(capacity) + " at frame " + std::to_string(i) + ", but the pool held " + std::to_string(active) + " active of " + std::to_string(total));
+
+            failed = true;
+        }
+
+        else if (i < 2000 && total != capacity)
+        {
+            fail("Expected grains to be recycled at a steady count, but the pool held " + std::to_string(total) + " at frame " + std::to_string(i));
+
+            failed = true;
+        }
+
+        else if (i >= 2700 && i < 4000 && total != 3)
+        {
+            fail("Expected stopped grains to leave the pool once they finish, but it held " + std::to_string(total) + " at frame " + std::to_string(i));
+
+            failed = true;
+        }
+
+        else if (i >= 4000 && total != capacity)
+        {
+            fail("Expected the pool to refill up to its capacity, but it held " + std::to_string(total) + " at frame " + std::to_string(i));
+
+            failed = true;
+        }
+    }
+
+    if (silent)
+    {
+        fail("Expected the grains to play the resource.");
+    }
+
+    std::filesystem::remove(path.string());
+
+    endTest();
+}
+
+void TestSources::testGrainShape()
+{
+    beginTest("Tabulated grain shape", true);
+
+    const size_t frames = 9000;
+    const size_t tabulated = Granulate::shapeResolution;
+
+    RandomStream samples;
+
+    std::vector<float> audio(2000 * utils->channels);
+
+    for (float& sample : audio)
+    {
+        sample = samples.uniform(-1, 1);
+    }
+
+    const Path path = writeAudio("shape.wav", audio, utils->channels, utils->sampleRate);
+
+    const std::unique_ptr<Resource> resource(new Resource(SharedResourceData(readAudio(path))));
+
+    ShapeCoordinator coordinator;
+    GrainShape shape(&coordinator);
+
+    RandomStream tableRandom(1, 2);
+    RandomStream sampleRandom(1, 2);
+
+    GrainPool table(&tableRandom);
+    GrainPool sampled(&sampleRandom);
+
+    table.reserve(8);
+    sampled.reserve(8);
+
+    table.tabulate(&shape, &coordinator, tabulated);
+
+    std::vector<double> expected(utils->channels);
+    std::vector<double> actual(utils->channels);
+
+    bool failed = false;
+
+    for (size_t i = 0; i < frames && !failed; i++)
+    {
+        // grains at the tabulated length read the table at its own points,
+        // shorter and longer ones interpolate between them
+
+        const size_t length = i < 3000 ? tabulated : i < 6000 ? 450 : 1800;
+        const double epsilon = i < 3000 ? 1e-12 : 1e-4;
+
+        std::fill(expected.begin(), expected.end(), 0);
+        std::fill(actual.begin(), actual.end(), 0);
+
+        while (table.getActiveLength() < 8)
+        {
+            table.spawn(resource.get(), length);
+            sampled.spawn(resource.get(), length);
+        }
+
+        table.apply(actual.data(), resource.get(), &shape, &coordinator, length, 8);
+        sampled.apply(expected.data(), resource.get(), &shape, &coordinator, length, 8);
+
+        for (size_t j = 0; j < utils->channels; j++)
+        {
+            if (!failed && fabs(actual[j] - expected[j]) > epsilon)
+            {
+                fail("Expected " + TestUtils::formatDouble(expected[j]) + " at frame " + std::to_string(i) + ", but received " + TestUtils::formatDouble(actual[j]));
+
+                failed = true;
+            }
+        }
+    }
+
+    std::filesystem::remove(path.string());
+
+    endTest();
+}
+
+void TestSources::testGrainSnapshot()
+{
+    beginTest("Grain pool snapshots", true);
+
+    RandomStream samples;
+
+    std::vector<float> audio(2000 * utils->channels);
+
+    for (float& sample : audio)
+    {
+        sample = samples.uniform(-1, 1);
+    }
+
+    const Path path = writeAudio("snapshot.wav", audio, utils->channels, utils->sampleRate);
+
+    const std::unique_ptr<Resource> resource(new Resource(SharedResourceData(readAudio(path))));
+
+    ShapeCoordinator coordinator;
+    GrainShape shape(&coordinator);
+
+    RandomStream random(1, 2);
+
+    GrainPool pool(&random);
+
+    pool.reserve(4);
+    pool.tabulate(&shape, &coordinator, 64);
+
+    while (pool.getActiveLength() < 4)
+    {
+        pool.spawn(resource.get(), 700);
+    }
+
+    Snapshot saved;
+
+    pool.serialize(saved, resource.get());
+
+    const std::vector<char>& state = saved.getData();
+
+    // the header is followed by the grain and active counts, then the
+    // starts, positions, lengths and active flags of each grain
+
+    const size_t header = sizeof(uint32_t) * 2;
+    const size_t positions = header + sizeof(size_t) * (2 + 4);
+
+    const auto tamper = [&](const size_t offset, const size_t value)
+    {
+        std::vector<char> data = state;
+
+        memcpy(data.data() + offset, &value, sizeof(size_t));
+
+        return data;
+    };
+
+    const std::vector<std::pair<std::string, std::vector<char>>> snapshots = {
+        { "a truncated snapshot", std::vector<char>(state.begin(), state.end() - 1) },
+        { "a grain count past the payload", tamper(header, (size_t)-1 / 2) },
+        { "more active grains than grains", tamper(header + sizeof(size_t), 5) },
+        { "a position outside the resource", tamper(positions, resource->frames + 1) },
+        { "an envelope past the payload", tamper(state.size() - sizeof(double) * 65 - sizeof(size_t), (size_t)-1) }
+    };
+
+    for (const auto& [name, data] : snapshots)
+    {
+        GrainPool restored(&random);
+
+        try
+        {
+            Snapshot snapshot(data);
+
+            restored.serialize(snapshot, resource.get());
+            snapshot.finish();
+
+            fail("Expected " + name + " to be rejected.");
+        }
+
+        catch (const OrganicFileException& e) {}
+    }
+
+    GrainPool restored(&random);
+
+    try
+    {
+        Snapshot snapshot(state);
+
+        restored.serialize(snapshot, resource.get());
+        snapshot.finish();
+
+        if (restored.getTotalLength() != 4 || restored.getActiveLength() != 4 || !restored.isTabulated())
+        {
+            fail("Expected the restored pool to hold 4 active grains and its envelope.");
+        }
+    }
+
+    catch (const OrganicFileException& e)
+    {
+        failWithError(e);
+    }
+
+    std::filesystem::remove(path.string());
+
+    endTest();
+}
@@ -0,0 +1,104 @@
+#include "engine/test_sources.h"
+
+void TestSources::testWaveform()
+{
+    expectWaveform("Sine waveform", [](const double phase) { return Waveform::sine(phase); }, [](double* values, const size_t count) { Waveform::sine(values, count); }, [](const double phase)
+    {
+        return sin(phase);
+    }, 1e-9);
+
+    expectWaveform("Square waveform", [](const double phase) { return Waveform::square(phase); }, [](double* values, const size_t count) { Waveform::square(values, count); }, [](const double phase)
+    {
+        return sin(phase) > 0 ? -1 : 1;
+    }, 0);
+
+    expectWaveform("Saw waveform", [](const double phase) { return Waveform::saw(phase); }, [](double* values, const size_t count) { Waveform::saw(values, count); }, [](const double phase)
+    {
+        const double wrapped = fmod(phase, 2 * M_PI);
+
+        return (wrapped < 0 ? wrapped + 2 * M_PI : wrapped) / M_PI - 1;
+    }, 1e-9);
+
+    expectWaveform("Triangle waveform", [](const double phase) { return Waveform::triangle(phase); }, [](double* values, const size_t count) { Waveform::triangle(values, count); }, [](const double phase)
+    {
+        return 2 * asin(sin(phase)) / M_PI;
+    }, 1e-9);
+}
+
+void TestSources::expectWaveform(const std::string& name, const std::function<double(double)>& kernel, const std::function<void(double*, size_t)>& block, const std::function<double(double)>& reference, const double epsilon)
+{
+    beginTest(name, true);
+
+    // steps are chosen so that no frame lands close to a discontinuity,
+    // large and negative steps cross the wrap point on every frame
+
+    const std::vector<double> deltas = {0.01234, -0.01234, 2.5, -2.5, 7.654321, -7.654321, 1000.1234, -1000.1234};
+    const size_t frames = 1000;
+
+    std::vector<double> phases(frames);
+    std::vector<double> expected(frames);
+
+    for (const double delta : deltas)
+    {
+        std::unique_ptr<Phase> phase(new Phase());
+
+        phase->start(utils->time);
+        phase->setDelta(delta);
+
+        for (size_t i = 0; i < frames; i++)
+        {
+            utils->frame++;
+
+            phase->update();
+
+            phases[i] = phase->getValue();
+            expected[i] = reference(delta * (i + 1));
+        }
+
+        for (size_t i = 0; i < frames; i++)
+        {
+            if (phases[i] < 0 || phases[i] > 2 * M_PI)
+            {
+                fail("Expected phase within [0, 2pi] with step " + TestUtils::formatDouble(delta) + ", but received " + TestUtils::formatDouble(phases[i]));
+
+                break;
+            }
+
+            const double actual = kernel(phases[i]);
+
+            if (fabs(actual - expected[i]) > epsilon)
+            {
+                fail("Expected " + TestUtils::formatDouble(expected[i]) + " at frame " + std::to_string(i) + " with step " + TestUtils::formatDouble(delta) + ", but received " + TestUtils::formatDouble(actual));
+
+                break;
+            }
+        }
+
+        block(phases.data(), frames);
+
+        for (size_t i = 0; i < frames; i++)
+        {
+            if (fabs(phases[i] - expected[i]) > epsilon)
+            {
+                fail("Expected block value " + TestUtils::formatDouble(expected[i]) + " at frame " + std::to_string(i) + " with step " + TestUtils::formatDouble(delta) + ", but received " + TestUtils::formatDouble(phases[i]));
+
+                break;
+            }
+        }
+
+        std::unique_ptr<Phase> advance(new Phase());
+
+        advance->start(utils->time);
+        advance->setDelta(delta);
+        advance->advance(frames);
+
+        const double advanced = advance->getValue();
+
+        if (advanced < 0 || advanced > 2 * M_PI || fabs(kernel(advanced) - reference(delta * frames)) > epsilon)
+        {
+            fail("Expected advancing " + std::to_string(frames) + " frames with step " + TestUtils::formatDouble(delta) + " to match " + TestUtils::formatDouble(reference(delta * frames)) + ", but received " + TestUtils::formatDouble(kernel(advanced)));
+        }
+    }
+
+    endTest();
+}
@@ -51,6 +51,10 @@ void TestControllers::test()
     testMax();
     testRound();
     testAbsolute();
+    testVariable();
+    testControlRate();
+    testBlock();
+    testSharedBlock();
 }
 
 TestControllers::TestControllers(TestTracker* tracker) :
@@ -115,12 +119,15 @@ void TestControllers::expectValues(std::unique_ptr<ValueObject>& object, const s
 
         while (utils->time < value.time)
         {
+            utils->frame++;
+
             object->update();
 
             utils->time += utils->timeStep;
         }
 
         utils->time = value.time;
+        utils->frame++;
 
         object->update();
 
@@ -192,12 +199,15 @@ void TestControllers::expectValues(std::unique_ptr<ValueObject>& object, const s
 
         while (utils->time < value.time)
         {
+            utils->frame++;
+
             object->update();
 
             utils->time += utils->timeStep;
         }
 
         utils->time = value.time;
+        utils->frame++;
 
         object->update();
 
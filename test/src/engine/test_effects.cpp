@@ -0,0 +1,39 @@
+#include "engine/test_effects.h"
+
+using namespace Engine;
+
+void TestEffects::run(TestTracker* tracker)
+{
+    TestEffects* test = new TestEffects(tracker);
+
+    test->test();
+
+    delete test;
+}
+
+void TestEffects::test()
+{
+    beginSuite("Test effects");
+
+    testDelayBuffer();
+    testDelayMatrix();
+    testBiquad();
+    testFFT();
+    testConvolve();
+}
+
+TestEffects::TestEffects(TestTracker* tracker) :
+    Test(tracker), utils(Utils::get()) {}
+
+void TestEffects::expectBuffer(const std::vector<double>& expected, const std::vector<double>& actual, const double epsilon)
+{
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        if (fabs(actual[i] - expected[i]) > epsilon)
+        {
+            fail("Expected " + TestUtils::formatDouble(expected[i]) + " at index " + std::to_string(i) + ", but received " + TestUtils::formatDouble(actual[i]));
+
+            return;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#include "engine/test_resources.h"
+
+using namespace Engine;
+
+void TestResources::run(TestTracker* tracker)
+{
+    TestResources* test = new TestResources(tracker);
+
+    test->test();
+
+    delete test;
+}
+
+void TestResources::test()
+{
+    beginSuite("Test resources");
+
+    testCache();
+    testDeduplication();
+    testMix();
+}
+
+TestResources::TestResources(TestTracker* tracker) :
+    Test(tracker), utils(Utils::get()) {}
+
+void TestResources::expectSamples(const std::vector<float>& expected, const ResourceData* data)
+{
+    if (data->frames * utils->channels != expected.size())
+    {
+        fail("Expected " + std::to_string(expected.size() / utils->channels) + " frames, but received " + std::to_string(data->frames));
+
+        return;
+    }
+
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        if (data->samples[i] != expected[i])
+        {
+            fail("Expected " + TestUtils::formatDouble(expected[i]) + " at index " + std::to_string(i) + ", but received " + TestUtils::formatDouble(data->samples[i]));
+
+            return;
+        }
+    }
+}
@@ -0,0 +1,26 @@
+#include "engine/test_sources.h"
+
+using namespace Engine;
+
+void TestSources::run(TestTracker* tracker)
+{
+    TestSources* test = new TestSources(tracker);
+
+    test->test();
+
+    delete test;
+}
+
+void TestSources::test()
+{
+    beginSuite("Test sources");
+
+    testWaveform();
+    testOscillatorBank();
+    testGrainPool();
+    testGrainShape();
+    testGrainSnapshot();
+}
+
+TestSources::TestSources(TestTracker* tracker) :
+    Test(tracker), utils(Utils::get()) {}
@@ -8,13 +8,19 @@
 #include "../include/test_utils.h"
 #include "../include/test_value.h"
 #include "../include/engine/test_controllers.h"
+#include "../include/engine/test_effects.h"
+#include "../include/engine/test_resources.h"
+#include "../include/engine/test_sources.h"
 
 int main(int argc, char** argv)
 {
-    Utils* utils = Utils::get();
+    Utils* utils = new Utils();
+
+    Utils::set(utils);
 
     utils->channels = 2;
     utils->sampleRate = 44100;
+    utils->bufferLength = 128;
     utils->timeStep = 1000.0 / utils->sampleRate;
 
     TestTracker* tracker = new TestTracker();
@@ -28,6 +34,9 @@ int main(int argc, char** argv)
         TestResolver::run(tracker);
         TestValue::run(tracker);
         TestControllers::run(tracker);
+        TestSources::run(tracker);
+        TestEffects::run(tracker);
+        TestResources::run(tracker);
         TestExamples::run(tracker);
     }
 
@@ -13,6 +13,33 @@ const Path Test::testPath(const std::string& file) const
     return Path::relative(file, ORGANIC_TEST_DIR);
 }
 
+const Path Test::tempPath(const std::string& file) const
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "organic-test";
+
+    std::filesystem::create_directories(directory);
+
+    return Path::relative(file, directory);
+}
+
+const Path Test::writeAudio(const std::string& file, const std::vector<float>& samples, const unsigned int channels, const unsigned int sampleRate) const
+{
+    const Path path = tempPath(file);
+
+    SndfileHandle handle(path.string(), SFM_WRITE, SF_FORMAT_WAV | SF_FORMAT_FLOAT, channels, sampleRate);
+
+    handle.write(samples.data(), samples.size());
+
+    return path;
+}
+
+Engine::ResourceData* Test::readAudio(const Path& path, const std::optional<Path>& cacheDirectory) const
+{
+    const NamedSourceProvider source(path, "");
+
+    return new Engine::ResourceData(path, SourceLocation(&source, 0, 0), cacheDirectory);
+}
+
 void Test::beginSuite(const std::string& name) const
 {
     TestUtils::printSuccess("[ " + name + " ]");
@@ -17,6 +17,78 @@ void TestExamples::test()
     {
         expectSuccess(path);
     }
+
+    beginSuite("Render examples in blocks");
+
+    for (const Path& path : sourcePath("examples").children())
+    {
+        expectBlockRender(path);
+    }
+
+    beginSuite("Render examples with bytecode");
+
+    for (const Path& path : sourcePath("examples").children())
+    {
+        expectBytecodeRender(path);
+    }
+
+    beginSuite("Render examples on separate threads");
+
+    for (const Path& path : sourcePath("examples").children())
+    {
+        expectThreadedRender(path);
+    }
+
+    beginSuite("Render examples with worker threads");
+
+    for (const Path& path : sourcePath("examples").children())
+    {
+        expectParallelRender(path);
+    }
+
+    beginSuite("Restore examples from snapshots");
+
+    for (const Path& path : sourcePath("examples").children())
+    {
+        expectRestoredRender(path);
+    }
+
+    beginSuite("Reject incompatible snapshots");
+
+    for (const Path& path : sourcePath("examples").children())
+    {
+        expectRejectedSnapshot(path);
+    }
+
+    beginSuite("Render programs with worker threads");
+
+    for (const Path& path : testPath("parallel").children())
+    {
+        expectParallelRender(path);
+    }
+
+    beginSuite("Seek examples");
+
+    for (const Path& path : sourcePath("examples").children())
+    {
+        expectSeekRender(path);
+    }
+
+    beginSuite("Seek programs");
+
+    for (const Path& path : testPath("seek").children())
+    {
+        expectSeekRender(path);
+    }
+
+    expectSeekRender(writeGranulate());
+
+    beginSuite("Control rate programs");
+
+    for (const Path& path : testPath("control").children())
+    {
+        expectControlRender(path);
+    }
 }
 
 TestExamples::TestExamples(TestTracker* tracker) :
@@ -47,7 +119,14 @@ void TestExamples::expectSuccess(const Path& path)
 
         program->resolveTypes();
 
-        delete program->transform(transformer);
+        Engine::Program* engine = program->transform(transformer);
+
+        if (engine->getMemoryUsage() == 0)
+        {
+            fail("Expected program objects to be allocated from its arena.");
+        }
+
+        delete engine;
     }
 
     catch (const OrganicException& e)
@@ -61,3 +140,385 @@ void TestExamples::expectSuccess(const Path& path)
 
     endTest();
 }
+
+void TestExamples::expectBlockRender(const Path& path)
+{
+    beginTest(path.stem(), true);
+
+    try
+    {
+        expectSameRender(render(path, 1, false), render(path, Utils::get()->bufferLength, false));
+    }
+
+    catch (const OrganicException& e)
+    {
+        failWithError(e);
+    }
+
+    endTest();
+}
+
+void TestExamples::expectBytecodeRender(const Path& path)
+{
+    beginTest(path.stem(), true);
+
+    try
+    {
+        expectSameRender(render(path, Utils::get()->bufferLength, false), render(path, Utils::get()->bufferLength, true));
+    }
+
+    catch (const OrganicException& e)
+    {
+        failWithError(e);
+    }
+
+    endTest();
+}
+
+void TestExamples::expectThreadedRender(const Path& path)
+{
+    beginTest(path.stem(), true);
+
+    try
+    {
+        const std::vector<double> expected = render(path, Utils::get()->bufferLength, false);
+
+        std::future<std::vector<double>> first = std::async(std::launch::async, &TestExamples::renderThreaded, this, path, Utils::get());
+        std::future<std::vector<double>> second = std::async(std::launch::async, &TestExamples::renderThreaded, this, path, Utils::get());
+
+        expectSameRender(expected, first.get());
+        expectSameRender(expected, second.get());
+    }
+
+    catch (const OrganicException& e)
+    {
+        failWithError(e);
+    }
+
+    endTest();
+}
+
+void TestExamples::expectParallelRender(const Path& path)
+{
+    beginTest(path.stem(), true);
+
+    try
+    {
+        const std::vector<double> expected = render(path, Utils::get()->bufferLength, false);
+
+        for (const unsigned int threads : { 2, 3, 4 })
+        {
+            expectSameRender(expected, render(path, Utils::get()->bufferLength, false, threads));
+        }
+    }
+
+    catch (const OrganicException& e)
+    {
+        failWithError(e);
+    }
+
+    endTest();
+}
+
+void TestExamples::expectRestoredRender(const Path& path)
+{
+    beginTest(path.stem(), true);
+
+    try
+    {
+        expectSameRender(render(path, Utils::get()->bufferLength, false), renderRestored(path));
+    }
+
+    catch (const OrganicException& e)
+    {
+        failWithError(e);
+    }
+
+    endTest();
+}
+
+void TestExamples::expectRejectedSnapshot(const Path& path)
+{
+    beginTest(path.stem(), true);
+
+    Engine::Program* engine = nullptr;
+
+    try
+    {
+        engine = compile(path, false);
+
+        engine->start(0);
+
+        const std::vector<char> state = engine->save();
+
+        std::vector<char> version = state;
+        std::vector<char> swapped = state;
+
+        version[4]++;
+
+        std::reverse(swapped.begin(), swapped.begin() + 4);
+
+        for (const std::vector<char>& data : { version, swapped, std::vector<char>(state.begin() + 8, state.end()), std::vector<char>(state.begin(), state.end() - 1) })
+        {
+            try
+            {
+                engine->restore(data);
+
+                fail("Expected an incompatible snapshot to be rejected.");
+            }
+
+            catch (const OrganicFileException& e) {}
+        }
+
+        engine->restore(state);
+    }
+
+    catch (const OrganicException& e)
+    {
+        failWithError(e);
+    }
+
+    delete engine;
+
+    endTest();
+}
+
+void TestExamples::expectSeekRender(const Path& path)
+{
+    beginTest(path.stem(), true);
+
+    try
+    {
+        // long enough for the swept and modulated frequencies in the
+        // examples to change several times before the later target
+
+        const Utils* utils = Utils::get();
+
+        const size_t frames = utils->sampleRate * 4;
+
+        const std::vector<double> expected = render(path, utils->bufferLength, false, 1, 4);
+
+        for (const size_t target : { utils->sampleRate / 2, utils->sampleRate * 3 + 77 })
+        {
+            const std::vector<double> actual = renderSeek(path, frames, target);
+
+            const size_t offset = target * utils->channels;
+
+            expectSameRender(std::vector<double>(expected.begin() + offset, expected.end()), std::vector<double>(actual.begin() + offset, actual.end()), 1e-9);
+        }
+    }
+
+    catch (const OrganicException& e)
+    {
+        failWithError(e);
+    }
+
+    endTest();
+}
+
+void TestExamples::expectSameRender(const std::vector<double>& expected, const std::vector<double>& actual, const double epsilon)
+{
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        if (fabs(expected[i] - actual[i]) > epsilon)
+        {
+            fail("Expected sample " + std::to_string(i) + " to be " + TestUtils::formatDouble(expected[i]) + ", but received " + TestUtils::formatDouble(actual[i]));
+
+            return;
+        }
+    }
+}
+
+void TestExamples::expectControlRender(const Path& path)
+{
+    beginTest(path.stem(), true);
+
+    try
+    {
+        // the envelope is a repeated sequence of sweeps, so it only differs
+        // from audio rate if it was wrapped, and then by at most the change
+        // of its steepest sweep over two periods
+
+        const Utils* utils = Utils::get();
+
+        const unsigned int period = 32;
+        const double tolerance = 0.15 / (utils->sampleRate * 0.04) * period * 2;
+
+        const std::vector<double> expected = render(path, utils->bufferLength, false);
+        const std::vector<double> actual = render(path, utils->bufferLength, false, 1, 1, period);
+
+        double difference = 0;
+
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            difference = std::max(difference, fabs(actual[i] - expected[i]));
+        }
+
+        if (difference == 0)
+        {
+            fail("Expected the envelope to be rendered at control rate, but it matched the audio rate render.");
+        }
+
+        else if (difference > tolerance)
+        {
+            fail("Expected the control rate render to stay within " + TestUtils::formatDouble(tolerance) + " of the audio rate render, but it differed by " + TestUtils::formatDouble(difference));
+        }
+    }
+
+    catch (const OrganicException& e)
+    {
+        failWithError(e);
+    }
+
+    endTest();
+}
+
+std::vector<double> TestExamples::render(const Path& path, const size_t blockLength, const bool bytecode, const unsigned int threads, const size_t seconds, const unsigned int controlPeriod) const
+{
+    Utils* utils = Utils::get();
+
+    utils->threads = threads;
+
+    Engine::Program* engine = compile(path, bytecode, controlPeriod);
+
+    utils->threads = 1;
+
+    const size_t frames = utils->sampleRate * seconds;
+
+    std::vector<double> samples(frames * utils->channels);
+
+    engine->start(0);
+
+    for (size_t i = 0; i < frames; i += blockLength)
+    {
+        engine->processBlock(samples.data() + i * utils->channels, std::min(blockLength, frames - i));
+    }
+
+    delete engine;
+
+    return samples;
+}
+
+std::vector<double> TestExamples::renderThreaded(const Path& path, const Utils* parent) const
+{
+    Utils* utils = new Utils(*parent);
+
+    Utils::set(utils);
+
+    const std::vector<double> samples = render(path, utils->bufferLength, false);
+
+    Engine::Defaults::deinit();
+
+    Utils::set(nullptr);
+
+    delete utils;
+
+    return samples;
+}
+
+std::vector<double> TestExamples::renderRestored(const Path& path) const
+{
+    Utils* utils = Utils::get();
+
+    const size_t frames = utils->sampleRate;
+    const size_t half = frames / 2;
+
+    std::vector<double> samples(frames * utils->channels);
+
+    Engine::Program* engine = compile(path, false);
+
+    engine->start(0);
+
+    for (size_t i = 0; i < half; i += utils->bufferLength)
+    {
+        engine->processBlock(samples.data() + i * utils->channels, std::min<size_t>(utils->bufferLength, half - i));
+    }
+
+    const std::vector<char> state = engine->save();
+
+    delete engine;
+
+    engine = compile(path, false);
+
+    engine->start(0);
+    engine->restore(state);
+
+    for (size_t i = half; i < frames; i += utils->bufferLength)
+    {
+        engine->processBlock(samples.data() + i * utils->channels, std::min<size_t>(utils->bufferLength, frames - i));
+    }
+
+    delete engine;
+
+    return samples;
+}
+
+std::vector<double> TestExamples::renderSeek(const Path& path, const size_t frames, const size_t target) const
+{
+    Utils* utils = Utils::get();
+
+    std::vector<double> samples(frames * utils->channels);
+
+    Engine::Program* engine = compile(path, false);
+
+    engine->start(0);
+    engine->seek(target);
+
+    for (size_t i = target; i < frames; i += utils->bufferLength)
+    {
+        engine->processBlock(samples.data() + i * utils->channels, std::min<size_t>(utils->bufferLength, frames - i));
+    }
+
+    delete engine;
+
+    return samples;
+}
+
+Engine::Program* TestExamples::compile(const Path& path, const bool bytecode, const unsigned int controlPeriod) const
+{
+    Utils* utils = Utils::get();
+
+    utils->setSeed(0);
+    utils->setFrame(0);
+
+    const FileProvider* source = FileProvider::create(path);
+
+    const Parser::Program* program = Parser::Parser::parseSource(source);
+
+    program->resolveTypes();
+
+    TokenTransformer* transformer = new TokenTransformer(path, bytecode, controlPeriod);
+
+    Engine::Program* engine = program->transform(transformer);
+
+    delete transformer;
+    delete program;
+    delete source;
+
+    return engine;
+}
+
+const Path TestExamples::writeGranulate() const
+{
+    // granular sources need an audio file, so the program is written next to
+    // a generated sample rather than kept with the other fixtures
+
+    const Utils* utils = Utils::get();
+
+    std::vector<float> audio(utils->sampleRate / 4 * utils->channels);
+
+    for (size_t i = 0; i < audio.size(); i++)
+    {
+        audio[i] = sin(i * 0.37) * cos(i * 0.0013);
+    }
+
+    writeAudio("granulate.wav", audio, utils->channels, utils->sampleRate);
+
+    const Path path = tempPath("granulate.organic");
+
+    std::ofstream stream(path.string());
+
+    stream << "granulate(volume: sweep(from: 0.2, to: 0.6, length: 2500), sample: \"granulate.wav\", grains: 6, length: 40)" << std::endl;
+
+    return path;
+}
@@ -35,9 +35,11 @@ void TestUtils::printError(const std::string& text, const size_t indents)
 
 std::string TestUtils::formatDouble(const double value)
 {
-    char buffer[32];
+    // large enough for any finite double, which %f prints without an exponent
 
-    int end = snprintf(buffer, 32, "%f", value);
+    char buffer[512];
+
+    int end = snprintf(buffer, 512, "%f", value);
 
     while (end > 0 && buffer[end - 1] == '0')
     {
@@ -17,14 +17,26 @@ void TestValue::test()
     {
         for (const OTest* info : OTest::read(path))
         {
-            expectValue(info);
+            expectValue(info, false);
+
+            delete info;
+        }
+    }
+
+    beginSuite("Expression value (bytecode)");
+
+    for (const Path& path : testPath("value").children())
+    {
+        for (const OTest* info : OTest::read(path))
+        {
+            expectValue(info, true);
 
             delete info;
         }
     }
 }
 
-void TestValue::expectValue(const OTest* info)
+void TestValue::expectValue(const OTest* info, const bool bytecode)
 {
     beginTest(info);
 
@@ -32,7 +44,7 @@ void TestValue::expectValue(const OTest* info)
 
     const Parser::Program* program = nullptr;
 
-    TokenTransformer* transformer = new TokenTransformer(source->path());
+    TokenTransformer* transformer = new TokenTransformer(source->path(), bytecode);
 
     try
     {
@@ -51,14 +63,28 @@ void TestValue::expectValue(const OTest* info)
         {
             object->start(0);
 
-            const double expected = info->getValue("value")->asDouble();
             const double actual = object->getValue();
 
-            if (fabs(actual - expected) > std::numeric_limits<double>::epsilon())
+            if (info->getValue("nan")->asBoolean())
             {
-                fail("Expected expression to evaluate to " + TestUtils::formatDouble(expected) + ", but it evaluated to " + TestUtils::formatDouble(actual) + ".");
+                if (!std::isnan(actual))
+                {
+                    fail("Expected expression to evaluate to NaN, but it evaluated to " + TestUtils::formatDouble(actual) + ".");
+                }
             }
 
+            else
+            {
+                const double expected = info->getValue("value")->asDouble();
+
+                if (fabs(actual - expected) > std::numeric_limits<double>::epsilon())
+                {
+                    fail("Expected expression to evaluate to " + TestUtils::formatDouble(expected) + ", but it evaluated to " + TestUtils::formatDouble(actual) + ".");
+                }
+            }
+
+            expectFolding(info->getValue("kind")->asString(), object, bytecode);
+
             delete object;
         }
 
@@ -80,5 +106,53 @@ void TestValue::expectValue(const OTest* info)
     endTest();
 }
 
+void TestValue::expectFolding(const std::string& kind, const Engine::ValueObject* object, const bool bytecode)
+{
+    const bool constant = dynamic_cast<const Engine::Value*>(object);
+
+    if (kind.empty())
+    {
+        if (!constant)
+        {
+            fail("Expected constant expression to be folded into a single value.");
+        }
+
+        return;
+    }
+
+    if (constant)
+    {
+        fail("Expected expression with a non-constant operand not to be folded into a single value.");
+
+        return;
+    }
+
+    // the bytecode compiler folds into registers rather than nodes, so only
+    // the tree can be checked for which operations were kept
+
+    if (bytecode)
+    {
+        return;
+    }
+
+    const bool combination = dynamic_cast<const Engine::ValueCombination*>(object);
+    const bool square = dynamic_cast<const Engine::ValueSquare*>(object);
+
+    if (kind == "identity" && (combination || square))
+    {
+        fail("Expected identity operation to be replaced by its operand.");
+    }
+
+    else if (kind == "square" && !square)
+    {
+        fail("Expected power of two to be replaced by a square.");
+    }
+
+    else if (kind == "operation" && !combination)
+    {
+        fail("Expected operation with a non-constant operand to be kept.");
+    }
+}
+
 TestValue::TestValue(TestTracker* tracker) :
     Test(tracker) {}